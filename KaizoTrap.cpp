@@ -62,13 +62,20 @@
 #include <algorithm>
 #include <iostream>
 #include <cmath>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <map>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
                
-#define yoffoldy YWIDTH*movestack[movestackoff + 1]               
-#define yoffnewy YWIDTH*movestack[movestackoff + 3]
 #define humantieoffset counter + 1
 #define computerxwingoffset counter + 2              
 #define computertieoffset counter + 3               
-#define movestackoff curdepth*6               
                
 using namespace std;//to use cout without doing std::
 
@@ -76,7 +83,12 @@ using namespace std;//to use cout without doing std::
 const char MOVECHAR = 'o';//a character to indicate that at least one piece can move there.  MOstly for debugging purposes.
 const char EMPTYCHAR = '-';//a character to indicate that this piece is blank.
 
-const int MAXDEPTH = 8;//the maximum depth of the minimax algorithm by default.  Can change under certain circumstances..
+const int MAXDEPTH = 64;//the deepest the minimax algorithm can go.  The arrays for each depth are this big.
+int maxsearchdepth = MAXDEPTH;//don't deepen past this.  Set with -depth.  Each SearchContext gets its own copy.
+int movetime = 1000;//how many milliseconds the computer gets per move.  Set with -time.
+
+int deltapruning = 1;//1 to skip captures in the quiescence search that can't catch up to the best score.  Set with -delta.
+int jsonstats = 0;//1 to print each move's search stats as one line of JSON.  Set with -json.
 
 //heuristic values
 const int BELOWWORST = -256;//no heuristic value will go beyond these values.
@@ -84,104 +96,652 @@ const int ABOVEBEST = 256;
 
 const int XWIDTH = 7;//Just in case you try to make it modular.
 const int YWIDTH = 7;
-const int NUMOFSQUARES = 49;               
-char boardarray[YWIDTH*XWIDTH];//The board is global.  Or, interstellar, hehe.
+const int NUMOFSQUARES = 49;
+typedef unsigned long long bitboard;//all 49 squares fit in one 64 bit word.  Bit y*XWIDTH + x, same as the boardarray index.
+
+const bitboard FULLBOARD = (1ULL << NUMOFSQUARES) - 1;
+const bitboard WALLBOARD = (1ULL << 9) | (1ULL << 11) | (1ULL << 37) | (1ULL << 39);//'~' and '+'
+const bitboard COMPUTERDEATHSTAR = 1ULL << 10;//'*'
+const bitboard HUMANDEATHSTAR = 1ULL << 38;//'@'
+
+//directions to slide in.  X wings use the first four, in the same order the old corner cases walked them, tie fighters the last four.
+const int UPLEFT = 0;
+const int DOWNRIGHT = 1;
+const int UPRIGHT = 2;
+const int DOWNLEFT = 3;
+const int LEFT = 4;
+const int RIGHT = 5;
+const int UP = 6;
+const int DOWN = 7;
+constexpr int directionshift[8] = {-8, 8, -6, 6, -1, 1, -7, 7};//how far the bit index moves per step
+constexpr int directionx[8] = {-1, 1, 1, -1, -1, 1, 0, 0};
+constexpr int directiony[8] = {-1, 1, -1, 1, 0, 0, -1, 1};
+
+struct MoveTables
+{//everything about the board's geometry, worked out by the compiler so the move generator only looks things up.
+	bitboard rays[8][NUMOFSQUARES];//every square from a square to the board edge in a direction, not counting the square itself
+	bitboard forward[2][NUMOFSQUARES];//the rows in front of a square:  0 = human (up the board), 1 = computer (down the board)
+	bitboard deathstarhits[4][NUMOFSQUARES];//the enemy death star, if that piece type can hit it from the square.  Indexed by piecenum/NUMOFPIECES
+};
+
+constexpr MoveTables buildMoveTables()
+{//fill in the tables.  Runs at compile time.
+	MoveTables tables = {};
+	for (int square = 0; square < NUMOFSQUARES; square++)
+	{
+		int squarex = square % XWIDTH;
+		int squarey = square / XWIDTH;
+		for (int direction = 0; direction < 8; direction++)
+		{//walk to the edge, the way the old validateInput did.
+			int curx = squarex + directionx[direction];
+			int cury = squarey + directiony[direction];
+			for (; curx >= 0 && curx < XWIDTH && cury >= 0 && cury < YWIDTH; curx += directionx[direction], cury += directiony[direction])
+			{
+				tables.rays[direction][square] |= 1ULL << (cury*XWIDTH + curx);
+			}
+		}
+		for (int othersquare = 0; othersquare < NUMOFSQUARES; othersquare++)
+		{
+			if (othersquare / XWIDTH < squarey)
+			{
+				tables.forward[0][square] |= 1ULL << othersquare;
+			}
+			else if (othersquare / XWIDTH > squarey)
+			{
+				tables.forward[1][square] |= 1ULL << othersquare;
+			}
+		}
+	}
+	//the death stars can only be hit from behind:  diagonally for an x wing, straight on for a tie fighter.
+	tables.deathstarhits[0][2] = COMPUTERDEATHSTAR;//C7
+	tables.deathstarhits[0][4] = COMPUTERDEATHSTAR;//E7
+	tables.deathstarhits[1][3] = COMPUTERDEATHSTAR;//D7
+	tables.deathstarhits[2][44] = HUMANDEATHSTAR;//C1
+	tables.deathstarhits[2][46] = HUMANDEATHSTAR;//E1
+	tables.deathstarhits[3][45] = HUMANDEATHSTAR;//D1
+	return tables;
+}
+
+constexpr MoveTables movetables = buildMoveTables();
 
-//y x values, respectively.
-const int LISTSIZE = 420;//list size per depth, ex.  100 moves * 4 = 400 elements per depth for moves.
+const int LISTSIZE = 84;//moves per depth.
 /*x wings can go up to 6 moves going forwards, or two moves going backwards
 //8
 //tie fighters can go up to 6 moves going forwards, 6 moves going sideways, or one move going backwards.
 //13
-//each legal move requires 5 parts to it.
-//oldx, oldy, newx, newy, piecenum.
 //so, 8*4 + 13*4 = 32 + 52.
-//= 84 moves
-//84 * 5 = 420.*/
-
-int listoflegalmoves[LISTSIZE*MAXDEPTH];//There can be a maximum of 84 legal moves per turn, and 5 characters per move (old and new location).
-/*hence, 84 * 5 = 420.
-//Keep in mind this is an upper bound:  There can certainly be less moves.
-//And keep in mind this is an overestimate.
-//4 ties = 4 * 12 = 48
-//4 x wings = 4 * 12 = 48
-//oldx, oldy, newx, newy, piecenum*/
-
-int movenum[MAXDEPTH];//the displacer for listoflegalmoves.
-//The amount of list of moves is equal to the MAXDEPTH, since the same layer moves will just be removed.
-char userinput[4];//The user's way of inputting the four below variables.
+//= 84 moves*/
+
+//A move is packed into one 32 bit word, so a depth's whole list of moves is 336 bytes instead of 1680.
+typedef unsigned int Move;
+/*bits 0-5:  the square it moves from, y*XWIDTH + x like the boardarray index
+//bits 6-11:  the square it moves to
+//bits 12-15:  the piecenum of the piece moving
+//bit 16:  it captures a piece
+//bit 17:  it is a sideways tie fighter move
+//bit 18:  it hits the enemy death star*/
+const Move MOVECAPTURE = 1 << 16;
+const Move MOVEHORIZONTAL = 1 << 17;
+const Move MOVEDEATHSTAR = 1 << 18;
+const Move MOVESQUARES = (1 << 12) - 1;//just the from and to squares, to compare moves from different lists
+
+constexpr Move packMove(int from, int to, int piecenum)
+{
+	return (Move)from | ((Move)to << 6) | ((Move)piecenum << 12);
+}
+
+constexpr int moveFrom(Move move)
+{
+	return move & 63;
+}
+
+constexpr int moveTo(Move move)
+{
+	return (move >> 6) & 63;
+}
+
+constexpr int movedPiece(Move move)
+{
+	return (move >> 12) & 15;
+}
+
+char userinput[16];//The user's way of inputting the four below variables.  Room for the terminating zero, and a bit more typed by mistake.
 // int PIECEGONE = 15;//indicates that a piece is gone, by moving it out of bounds
 
 const int NUMOFPIECES = 4;//number of pieces, since same # of x wings and tie fighters, just use this number
 //Use these arrays to quickly find movable pieces, instead of iteratively searching the array for them.
 
 
-int piecepositions[NUMOFPIECES*8];//list of all piece positions.
-/*first four are human x wing
-//next four are human tie fighters
-//four comp x wing
-//four tie fighters.
-	//first part is y axis
-	//second part is x axis.*/
-
-int capturedpieces[NUMOFPIECES*4];//the list of captured pieces
-/*0 to 3 = human x wing
-//next four are human tie
-//next four are comp x wing
-//four tie fighters*/
-int captureindicator;//shows the order of pieces captured.  Put this in the captured pieces array,
-//to see which piece was captured first.
-int movestack[6*MAXDEPTH];//list of moves that are currently made.
-/*1:  piecetomovex:  old location
-//2:  piecetomovey
-//3:  piecenewx	:  new location
-//4:  piecenewy
-//5:  piecetomove, old location character.
-//6:  boardarray[yoffnewy + movestack[movestackoff+3]], new location character
-//TODO just use the move stack, pass in only depth when making and unmaking moves.*/
-
-int listofhorizontaltiemoves[24*MAXDEPTH];//if the piece moved horizontally a turn previous.
-//24 because 4 tie fighters can make up to 6 horizontal moves each.
-//movenum is stored here.
-int horizontalmovenum[MAXDEPTH];//the displacer for listofhorizontaltiemoves
-//so uhhh...a horizontal move num at 0 apparently is equal to horizontal human.  NOT GOOD.
-int horizontalhuman;//indicates if a horizontal move was made in the previous turn.
-int horizontalcomputer;
-int humanmovenum;//the move the human makes out of main.
-
-
-void setup();
-void printBoard();
-
-int legalXWing(int piecetomovex, int piecetomovey, int piecenewx, int piecenewy, char piecetomove, int curdepth, int piecenum);//see if the move is a valid x wing move
-int legalTieFighter(int piecetomovex, int piecetomovey, int piecenewx, int piecenewy, char piecetomove, int curdepth, int piecenum);//see if the move is a valid tie fighter move
-int validateInput( int piecetomovex, int piecetomovey, int piecenewx, int piecenewy, int curdepth, int piecenum);//see if the move in general is valid
-int checkGameOver();
-int checkNoMoves(int whichplayer, int curdepth);
-
-void findHumanMoves(int curdepth);//find a list of valid human moves
-void findComputerMoves(int curdepth);//find a list of valid computer moves
-int checkListOfMoves();//check the human move with the list of available human moves.
-int checkListOfHorizontalMoves(int movenumber, int curdepth);//check to see if the move made was horizontal tie.
-void showListOfMoves(int curdepth);
-void showAllMoves();//show all moves stored after a turn.
-void showNewMovesOnBoard(int newx, int newy);//debugging
-void cleanBoard();
-//void showPieces();//show all pieces
-//void showListStack(int curdepth);//show the list stack.
+struct alignas(64) Position
+{//where everything is on the board.  Nothing in here is global:  Each game, and each thread searching one, has its own Position,
+	//so copying a position to another thread is just an assignment.  Aligned so two threads' positions never share a cache line.
+	char boardarray[YWIDTH*XWIDTH];//kept for showing the board.  The move generator only looks at the bitboards below.
+	
+	bitboard pieceboards[4];//occupancy for each piece type, indexed by piecenum/NUMOFPIECES
+	/*0 = human x wings
+	//1 = human tie fighters
+	//2 = computer x wings
+	//3 = computer tie fighters*/
+	
+	int piecepositions[NUMOFPIECES*8];//list of all piece positions.
+	/*first four are human x wing
+	//next four are human tie fighters
+	//four comp x wing
+	//four tie fighters.
+		//first part is y axis
+		//second part is x axis.*/
+	
+	signed char squarepieces[NUMOFSQUARES];//the piecenum on each square, or NOPIECE.  Finding what a move captures is one lookup.
+	
+	int capturedpieces[NUMOFPIECES*4];//the list of captured pieces.  1 if captured, 0 if not.
+	/*0 to 3 = human x wing
+	//next four are human tie
+	//next four are comp x wing
+	//four tie fighters*/
+	int evaluation;//the piece advantage:  +1 for each human piece captured (AI is happy), -2 for each computer piece captured.
+	//Updated as pieces are captured and put back.  Positional terms could be kept the same way, in movePiece and resetPiecePosition.
+	bitboard zobristkey;//the key for the piece placement.  movePiece and resetPiecePosition keep it up to date.
+	int horizontalhuman;//2 if the human moved a tie fighter sideways last turn, so it can't this turn.  movePiece counts it down to 0.
+	int horizontalcomputer;
+};
+
+const int NOPIECE = -1;//an empty square in squarepieces, or no capture in an UndoRecord
+const int CAPTUREVALUES[4] = {1, 1, -2, -2};//what evaluation changes by when a piece is captured, by piecenum/NUMOFPIECES
+const char PIECECHARS[4] = {'x', 't', 'X', 'T'};//how each piece type is shown on the boardarray, by piecenum/NUMOFPIECES
+const char STARTNOTATION[] = "1TT1TT1/7/XX3XX/7/xx3xx/7/1tt1tt1 h 00 -";//the start position, in readNotation's notation
+const int NOTATIONSIZE = 96;//room for any position's notation, and the terminating zero
+
+//Zobrist hashing:  a random number for each piece type on each square.  Xor them together to get a key for the position.
+struct ZobristTables
+{
+	bitboard pieces[4][NUMOFSQUARES];//indexed by piecenum/NUMOFPIECES, like pieceboards
+	bitboard computertomove;//xored in when it is the computer's turn
+	bitboard horizontal[2][2];//whether each side's horizontal tie value is 2, 0 = human, 1 = computer.  0 and 1 play the same, so they share a key.
+};
+
+constexpr bitboard splitMix(bitboard& state)
+{//small random number generator.  Always the same numbers, so keys are the same every run.
+	state += 0x9E3779B97F4A7C15ULL;
+	bitboard mixed = state;
+	mixed = (mixed ^ (mixed >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	mixed = (mixed ^ (mixed >> 27)) * 0x94D049BB133111EBULL;
+	return mixed ^ (mixed >> 31);
+}
+
+constexpr ZobristTables buildZobristTables()
+{//fill in the zobrist numbers.  Runs at compile time.
+	ZobristTables tables = {};
+	bitboard state = 0x4B41495A4F545250ULL;//any seed will do
+	for (int piecetype = 0; piecetype < 4; piecetype++)
+	{
+		for (int square = 0; square < NUMOFSQUARES; square++)
+		{
+			tables.pieces[piecetype][square] = splitMix(state);
+		}
+	}
+	tables.computertomove = splitMix(state);
+	for (int side = 0; side < 2; side++)
+	{
+		for (int blocked = 0; blocked < 2; blocked++)
+		{
+			tables.horizontal[side][blocked] = splitMix(state);
+		}
+	}
+	return tables;
+}
 
-int evaluate(int curdepth);//evaluate the heuristic value.
-int maxMove(int curdepth, int beta);
-int minMove(int curdepth, int alpha);
-int makeAMove();
+constexpr ZobristTables zobrist = buildZobristTables();
+
+//Transposition table:  remembers positions that were already searched, so a position reached by a different move order isn't searched again.
+const int EXACTBOUND = 0;//the score is the real score
+const int LOWERBOUND = 1;//the search failed high:  The real score is at least this much
+const int UPPERBOUND = 2;//the search failed low:  The real score is at most this much
+const int NOSQUARE = 63;//no best move was stored
+const int TTBUCKETSIZE = 4;//entries per bucket.  4 entries of 16 bytes fill a 64 byte cache line.
+const int TTNUMOFBUCKETS = 1 << 18;//16 MB.  Has to be a power of two.
+const int ASPIRATIONWINDOW = 2;//how far from the last depth's score the root window starts.  Scores move by 1 or 2 a piece.
+const int WINNINGSCORE = ABOVEBEST - 128;//scores past this (either way) are game overs, which depend on the depth they were found at.
+
+struct TTEntry
+{//Lockless:  The key is stored xor'd with the data, so if two threads write an entry at the same time, the torn entry just doesn't match.
+	atomic<bitboard> key;//the whole key (xor data), so two positions in the same bucket can't be mixed up
+	atomic<bitboard> data;//score, depth, bound, best move and generation, packed together.  See packTransposition.
+};
+
+struct alignas(64) TTBucket
+{
+	TTEntry entries[TTBUCKETSIZE];
+};
+
+TTBucket transpositiontable[TTNUMOFBUCKETS];
+atomic<int> ttgeneration;//incremented every real move (by every game, in self play), so old entries are replaced first
+
+//Move ordering:  alpha beta cuts off more the sooner it sees the best move.  orderMoves sorts each list by these scores, highest first.
+const int HASHMOVESCORE = 1 << 30;//the transposition table's best move
+const int DEATHSTARSCORE = 1 << 29;//hitting the death star wins the game
+const int CAPTURESCORE = 1 << 28;//plus the victim's value times 16, minus the attacker's value
+const int KILLERSCORE = 1 << 27;//a quiet move that caused a cutoff at the same depth
+const int HISTORYMAX = 1 << 26;//the history table is halved when anything reaches this, so quiet moves stay below killers.
+const int PIECEVALUES[4] = {2, 1, 2, 1};//by piecenum/NUMOFPIECES.  X wings reach more squares than tie fighters.
+
+//Pondering:  while the human thinks, a thread guesses the human's reply and searches the answer to it.
+const int PONDERREPLIES = 3;//how many of the human's best looking replies get searched ahead of time
+const int PONDERGUESSDEPTH = 4;//how deep to look when guessing which replies the human will make
+int ponderenabled = 1;//Set with -ponder.
+atomic<int> ponderstop;//the main thread sets this when the human has moved
+thread* ponderthread = NULL;//not a plain global, since exit() would destroy it while it is still running
+
+struct SearchResult
+{//the best move in a position, from searchMoves
+	bitboard key;//the position searched, with the computer to move
+	Move move;
+	int score;
+	int depth;//the last depth that finished.  0 if none did.
+	int complete;//1 if the search stopped on its own, 0 if the human moved first.
+};
+
+Position pondersnapshot;//the position handed to the ponder thread, with the human to move
+SearchResult ponderresults[PONDERREPLIES];//the answers to the replies pondered so far
+int numofponderresults;
+
+//Lazy SMP:  helper threads search the same position as makeAMove from their own copies, and share what they find through the transposition table.
+const int MAXTHREADS = 64;
+int numofthreads = 1;//threads per search, counting the main one.  Set with -threads.
+atomic<int> helperstop;//makeAMove sets this when it is done
+Position rootsnapshot;//the position handed to the helper threads
+int rootplayer;//who is to move in it, 1 = computer, 0 = human
+SearchResult helperresults[MAXTHREADS];
+long long helpernodes[MAXTHREADS];
+
+//Young Brothers Wait:  once the first move of a node is searched, the rest of its moves are split off for other threads to steal.
+const int LAZYSMP = 0;
+const int YOUNGBROTHERSWAIT = 1;
+int parallelmode = LAZYSMP;//Set with -parallel lazy or -parallel ybw.
+const int SPLITMINDEPTH = 3;//don't split nodes with fewer plies than this left:  Copying the position costs more than searching them.
+int splitting;//1 while makeAMove's worker threads are running, so nodes can be split.
+
+struct SplitPoint
+{//a node whose moves are being searched by several threads
+	Position position;//the node's position
+	SplitPoint* parent;//the split point this node is under, if any.  A cutoff there stops the search here too.
+	int curdepth;
+	int searchdepth;
+	int whichplayer;//the player to move, 1 = computer, 0 = human
+	atomic<int> alpha;//raised as the moves come back
+	int beta;
+	Move moves[LISTSIZE];//the node's list of moves
+	int numofmoves;
+	atomic<int> nextmove;//the next move nobody has taken yet
+	atomic<int> pending;//moves other threads are searching right now
+	int best;
+	int bestmove;
+	atomic<int> cutoff;//1 once a move was good enough that the rest don't matter
+	atomic<int> timeup;//1 if a move's search ran out of time
+	mutex lock;//for updating best, bestmove and alpha together
+};
+
+struct alignas(64) WorkDeque
+{//a thread's split points, oldest first.  The owner adds and removes at the end, other threads steal from the front, which has the most work left.
+	mutex lock;
+	SplitPoint* splits[MAXDEPTH];
+	int numofsplits;
+};
+
+WorkDeque workdeques[MAXTHREADS];
+
+struct SearchStats
+{//counters for one move's search, kept in the SearchContext.  Whoever starts the search (makeAMove, self play) clears them.
+	long long plynodes[MAXDEPTH+1];//positions searched at each ply, quiescence plies included
+	long long plyleaves[MAXDEPTH+1];//positions scored without searching any moves below them:  the evaluation, or a game over
+	long long iterationnodes[MAXDEPTH+1];//the nodes each finished depth of iterative deepening took, for the branching factor
+	long long betacutoffs;//nodes where a move was good enough that the rest didn't need searching
+	long long firstmovecutoffs;//the ones where it was the first move tried.  The better the move ordering, the closer this is to betacutoffs.
+	long long alphanodes;//nodes where no move beat alpha
+	long long ttprobes;
+	long long tthits;//the position was in the transposition table
+	long long ttcutoffs;//and its score could be used without searching
+	long long quiescencenodes;//positions searched past the search depth
+	long long tbhits;//positions scored by an endgame tablebase
+	int depth;//the last depth that finished
+	long long milliseconds;
+};
+
+SearchStats helperstats[MAXTHREADS];//each helper thread's stats, added to makeAMove's when it is done
+
+struct UndoRecord
+{//what movePiece changed that the move itself can't tell resetPiecePosition.  One for each depth, next to the move stack.
+	int captured;//the piecenum the move captured, or NOPIECE
+	int evaluation;//the evaluation and zobrist key before the move, put straight back instead of worked out again
+	bitboard zobristkey;
+	int horizontal;//the moving side's horizontal tie value before the move
+};
+
+struct alignas(64) SearchContext
+{//everything a search changes besides the position:  the move lists, the move stack, the clock and the move ordering tables.
+	//Each thread searching has its own, passed down with the Position, so any number of searches (and games) can run in one process.
+	Move listoflegalmoves[LISTSIZE*MAXDEPTH];//There can be a maximum of 84 legal moves per turn.
+	/*Keep in mind this is an upper bound:  There can certainly be less moves.
+	//And keep in mind this is an overestimate.
+	//4 ties = 4 * 12 = 48
+	//4 x wings = 4 * 12 = 48*/
+	
+	int movenum[MAXDEPTH+1];//how many moves are in each depth's list.  One extra, since negamax resets it at MAXDEPTH before the quiescence search.
+	//The amount of list of moves is equal to the MAXDEPTH, since the same layer moves will just be removed.
+	Move movestack[MAXDEPTH];//the move currently made at each depth
+	UndoRecord undostack[MAXDEPTH];//what it changed.  movePiece fills it in, and resetPiecePosition only needs it and the move.
+	
+	
+	int searchdepth;//how deep the current iteration of the search goes.  makeAMove deepens this by one until time runs out.
+	long long nodecount;//positions searched in this move
+	int searchaborted;//1 if the search ran out of time, and has to give up on the current depth.  2 if a split point above it was cut off.
+	chrono::steady_clock::time_point searchstart;//when the current move's search started
+	int movetime;//how many milliseconds this search gets per move
+	int maxsearchdepth;//don't deepen past this
+	atomic<int>* stopflag;//the ponder thread and the helper threads also stop searching when this is set.
+	long long nodelimit;//stop after this many nodes.  0 for no limit.
+	int printinfo;//1 to print an info line for the text protocol after each depth
+	
+	int killermoves[MAXDEPTH][2];//the last two quiet moves (from*64 + to) that caused a cutoff, per depth
+	int historytable[2][NUMOFSQUARES][NUMOFSQUARES];//[side][from][to], how often (weighted by depth) a quiet move caused a cutoff
+	
+	int searchthreadnum;//which thread this is, for the work deques.  The main thread is 0.
+	SplitPoint* currentsplit;//the split point the current search is under, if any
+	
+	SearchStats stats;
+};
+
+//Self play:  the engine plays itself with nobody at the keyboard, to measure it.  Each worker thread plays whole games with its own
+//Position and SearchContext, one after another, until all of them are played.  Only the transposition table is shared.
+int selfplaygames = 0;//how many games to play.  Set with -selfplay.  0 plays the human, as usual.
+int selfplayworkers = 1;//how many games are played at once.  Set with -workers.
+int openingplies = 4;//random moves at the start of each game, so the games aren't all the same.  Set with -openingplies.
+bitboard selfplayseed = 1;//Set with -seed.  The same seed plays the same openings.
+int sidetime[2] = {-1, -1};//milliseconds per move for each side, 0 = human, 1 = computer.  -1 uses -time.  Set with -humantime and -computertime.
+int sidedepth[2] = {-1, -1};//the deepest each side searches.  -1 uses -depth.  Set with -humandepth and -computerdepth.
+const int MAXGAMEPLIES = 300;//a game this long is called a draw.
+atomic<int> nextselfplaygame;//the next game nobody has started
+mutex selfplaylock;//so the workers' lines don't get mixed up
+
+struct SelfPlayStats
+{//what one worker saw.  runSelfPlay adds them up at the end.
+	int wins[2];//games won by each side, 0 = human, 1 = computer
+	int draws;
+	int firstmoverwins;
+	long long plies;
+	long long searchedmoves;//not counting the random opening moves or book moves
+	long long bookmoves;
+	long long nodes;
+	long long searchmicroseconds;
+	SearchStats search;//all the searched moves' stats added up
+};
+
+
+//Perft:  count the positions a few plies ahead with the same move generator and make/unmake as the search, to check them and time them.
+const int BENCHDEPTH = 9;//the depth the bench signature is quoted at
+int runbench = 0;//1 to search the bench positions, then quit.  Set with -bench.
+int benchdepth = BENCHDEPTH;//Set with -benchdepth.
+const char* const BENCHPOSITIONS[] = {//openings, middle games and endings from self play, both sides to move
+	"1TT1TT1/7/XX3XX/7/xx3xx/7/1tt1tt1 h 00 -",
+	"1TT1TT1/7/XX3XX/7/xx3xx/7/1tt1tt1 c 00 -",
+	"1TT1TT1/7/2xx1XX/7/2XX1xx/7/1tt1tt1 c 00 -",
+	"2T1TT1/7/X1xx1XX/7/3X1xx/7/1Tt1tt1 h 00 t",
+	"1tT1TT1/7/3x1XX/7/x1XX1xx/7/2t1tt1 c 00 T",
+	"T1T1TT1/7/X2x1tX/7/xx1X2x/7/1tt1t2 c 02 X",
+	"T1T1T2/7/X2x2X/7/x2X2x/7/1tt1t2 c 02 xtXT",
+	"1T2Tt1/7/X5X/4X2/x5x/7/2t1t2 c 00 xxtXTT",
+	"1T3T1/7/X3x1X/4X2/x6/7/2t1t2 c 02 xxttXTT",
+	"3T1T1/7/2x3X/4X2/6x/1t5/4t2 h 02 xxttXXTT",
+	"5T1/1T5/6X/4X2/2X3x/7/3tt2 c 20 xxxttXTT",
+	"7/1T5/6X/4XT1/7/1t5/2X1t2 c 10 xxxxttXTT",
+};
+const int NUMOFBENCHPOSITIONS = sizeof(BENCHPOSITIONS)/sizeof(BENCHPOSITIONS[0]);
+int runmicrobench = 0;//1 to time the move generation and make/unmake kernels on their own, then quit.  Set with -microbench.
+const int MICROBENCHCORPUSSIZE = 8192;//the most positions timed:  the bench positions, and the ones a ply or two after them
+const int MICROBENCHSAMPLES = 16;//timed samples per kernel, for the spread
+const long long MICROBENCHSAMPLEOPS = 1 << 19;//about how many calls each sample times
+long long microbenchsink;//the kernels' results are added up here, so the compiler can't leave the calls out
+
+int perftdepth = 0;//count up to this depth.  Set with -perft.  0 doesn't run it.
+int perftdivide = 0;//1 to also show the count under each first move at the last depth.  Set with -divide.
+int perftfirst = 0;//who moves first from the start position, 0 = human, 1 = computer.  Set with -first human or -first computer.
+const char* perftmoves = "";//moves to make from the start position before counting, like "B3C4 F5E4".  Set with -moves.
+const char* perftposition = NULL;//a position to start from instead, in readNotation's notation.  Its side to move goes first.  Set with -position.
+atomic<int> nextperftmove;//the next first move no perft thread has taken
+int runperftsuite = 0;//1 to count the suite positions and check them against their known counts, then quit.  Set with -perftsuite.
+const int PERFTSUITEMAXDEPTH = 6;//the deepest count the suite knows
+struct PerftCase
+{
+	const char* notation;//the position, in readNotation's notation.  Its side to move goes first.
+	long long counts[PERFTSUITEMAXDEPTH + 1];//the counts at depth 1, 2, ... up to a 0.  Checked by hand against a separate move generator.
+};
+const PerftCase PERFTSUITE[] = {//the start position, positions where one side's TIEs can't move sideways, and some with captures
+	{"1TT1TT1/7/XX3XX/7/xx3xx/7/1tt1tt1 h 00 -", {16, 252, 3842, 57852, 905480}},
+	{"1TT1TT1/7/XX3XX/7/xx3xx/7/1tt1tt1 c 00 -", {16, 252, 3842, 57852, 905480}},
+	{"1TT1TT1/7/XX3XX/7/xx3xx/7/1tt1tt1 h 10 -", {16, 252, 3842, 57852}},//1 still lets the human move sideways
+	{"1TT1TT1/7/XX3XX/7/xx3xx/7/1tt1tt1 h 20 -", {12, 188, 3090, 46418, 716120}},//the human's TIEs are blocked for this move
+	{"1TT1TT1/7/XX3XX/7/xx3xx/7/t1t1tt1 c 20 -", {16, 188, 2859, 48319, 758121}},//after B1A1:  the human's TIEs are blocked next move
+	{"T1T1TT1/7/X2x1tX/7/xx1X2x/7/1tt1t2 c 02 X", {8, 118, 1695, 20659, 265947}},//the computer's TIEs are blocked
+	{"2T1TT1/7/X1xx1XX/7/3X1xx/7/1Tt1tt1 h 00 t", {11, 155, 1646, 19365}},
+	{"3T1T1/7/2x3X/4X2/6x/1t5/4t2 h 02 xxttXXTT", {16, 172, 2204, 31822, 406235}},
+	{"7/1T5/6X/4XT1/7/1t5/2X1t2 c 10 xxxxttXTT", {14, 103, 1361, 7723, 86169, 522691}},
+};
+const int NUMOFPERFTCASES = sizeof(PERFTSUITE)/sizeof(PERFTSUITE[0]);
+
+
+//Endgame tablebases:  once only a few pieces are left, every position is solved ahead of time by retrograde analysis, and the search looks
+//the answer up instead of searching.  There is one file for each set of pieces (how many of each type), mapped into memory read only.
+const int TBMAXPIECES = 4;//the most pieces a table can have.  The biggest 4 piece tables are 27 MB.
+const int TBSQUARES = NUMOFSQUARES - 6;//the squares a piece can be on:  not the walls or the death stars
+const int TBHEADERSIZE = 16;//"KZTB", the four piece counts, the longest distance, TBVERSION, then padding
+const int TBVERSION = 2;//tables without the longest distance in the header are version 0, and have to be generated again
+const int TBLOSS = 128;//a value is 0 for a draw, 1 to 127 if the side to move wins in that many plies, or TBLOSS plus the plies it loses in.
+const int TBMAXDISTANCE = 127;
+const int TBCHUNKSIZE = 4096;//positions a generator thread takes at a time
+int tbgenerate = 0;//generate every table with up to this many pieces, then quit.  Set with -tbgen.  0 doesn't.
+const char* tbpath = "tablebases";//where the tables are kept.  Set with -tbpath.
+int tbpieces = 0;//the most pieces in any table that is loaded.  The search doesn't probe positions with more.
+int tbmaxdistance = 0;//the longest win or loss in any table that is loaded, so the generator knows when it is done
+const unsigned char* tablebases[NUMOFPIECES+1][NUMOFPIECES+1][NUMOFPIECES+1][NUMOFPIECES+1];//each loaded table's values by piece counts, after the header
+atomic<long long> nexttbchunk;//the next chunk of positions no generator thread has taken
+
+struct TablebaseIndexing
+{//how a position becomes a place in its table.  The squares of each piece type are a combination, numbered with binomial coefficients, and
+	//the four combinations, the side to move and which sides moved a tie fighter sideways last turn make up the index.
+	int squareplace[NUMOFSQUARES];//each square's place among the TBSQUARES squares, or -1 if a piece can't be there
+	int placesquare[TBSQUARES];//and back
+	long long binomial[TBSQUARES + 1][NUMOFPIECES + 1];//how many ways k pieces of one type fit on the first n places
+};
+
+constexpr TablebaseIndexing buildTablebaseIndexing()
+{//fill in the tables.  Runs at compile time, like buildMoveTables.
+	TablebaseIndexing indexing = {};
+	int place = 0;
+	for (int square = 0; square < NUMOFSQUARES; square++)
+	{
+		indexing.squareplace[square] = -1;
+		if ((((WALLBOARD | COMPUTERDEATHSTAR | HUMANDEATHSTAR) >> square) & 1) == 0)
+		{
+			indexing.squareplace[square] = place;
+			indexing.placesquare[place] = square;
+			place++;
+		}
+	}
+	for (int places = 0; places <= TBSQUARES; places++)
+	{
+		indexing.binomial[places][0] = 1;
+		for (int pieces = 1; pieces <= NUMOFPIECES; pieces++)
+		{
+			indexing.binomial[places][pieces] = places == 0 ? 0 : indexing.binomial[places - 1][pieces - 1] + indexing.binomial[places - 1][pieces];
+		}
+	}
+	return indexing;
+}
 
-int getHumanMove();
+constexpr TablebaseIndexing tbindexing = buildTablebaseIndexing();
+
+
+//Opening book:  the positions the engine can reach in the first few plies, searched ahead of time.  The file is sorted by key and mapped
+//read only, so looking a position up is a binary search, and the first moves of a game don't need searching.
+struct BookEntry
+{//one position in the book
+	bitboard key;//positionKey, so the side to move and the horizontal tie values count
+	Move move;
+	short score;
+	short depth;
+};
+
+static_assert(sizeof(BookEntry) == 16, "the book file is an array of these");
+const int BOOKHEADERSIZE = 16;//"KZBK", then padding
+int bookplies = 0;//build a book of the first this many plies, then quit.  Set with -bookgen.  0 doesn't.
+int bookdepth = 10;//how deep the book's positions are searched.  Set with -bookdepth.
+const char* bookpath = "kaizotrap.book";//Set with -book.
+const BookEntry* book = NULL;//the mapped entries, sorted by key.  NULL if there is no book.
+long long numofbookentries = 0;
+
+//the text protocol:  a GUI or tournament manager sends one command a line on stdin, and gets one answer a line on stdout.  Nothing else is printed.
+int protocolmode = 0;//1 to talk the protocol instead of playing.  Set with -protocol.
+const int PROTOCOLLINESIZE = 8192;//room for a position command with a whole game's moves
+const int MOVEOVERHEAD = 50;//milliseconds kept back from the clock, for the lines to get there and back
+Position protocolposition;//the position set by the last position command
+int protocolplayer = 0;//who is to move in it, 1 = computer, 0 = human
+SearchContext protocolcontext;//the search thread's.  Kept from one search to the next, like the game's, for the history table.
+SearchContext pvcontext;//printSearchInfo's, so walking the principal variation doesn't write over the search's lists
+atomic<int> protocolstop;//stop sets this
+int protocolinfinite = 0;//1 after go infinite:  The best move isn't printed until stop.
+thread* protocolthread = NULL;//the search go started, if there is one
+mutex protocollock;//so the search thread's lines and the main thread's don't get mixed up
+
+//bulk analysis:  a file of positions in, one result line each out in the same order, searched -workers at a time.  The positions go
+//through a ring of slots:  Reading waits for a free slot, and writing waits for the next slot in order to be done, so memory stays the
+//same however long the file is.
+const int ANALYSISSLOTS = 256;//positions read but not written out yet, at most
+const int ANALYSISLINESIZE = 256;//a notation, and room for a comment after it
+const int ANALYSISOUTPUTSIZE = 1024;//the line, the result and a principal variation MAXDEPTH moves long
+const char* analysisinput = NULL;//one position a line, in readNotation's notation, or - for stdin.  Set with -analyse.  NULL doesn't run it.
+const char* analysisoutput = "-";//where the results go, - for stdout.  Set with -analysisoutput.
+long long analysisnodes = 0;//nodes to search each position for.  Set with -nodes.  0 for no limit.
+
+struct AnalysisSlot
+{//one position on its way through:  read, searched, then written out.  Position number sequence uses slot sequence % ANALYSISSLOTS.
+	char line[ANALYSISLINESIZE];
+	char output[ANALYSISOUTPUTSIZE];
+	int done;//1 once a worker has filled in output
+};
+
+AnalysisSlot analysisslots[ANALYSISSLOTS];
+mutex analysislock;//for the slots' done flags and the counts below
+condition_variable analysissignal;//any of them changed
+long long analysisread;//positions read so far
+long long analysistaken;//positions a worker has started on
+long long analysiswritten;//positions written out
+int analysisfinished;//1 when the input has run out
+
+
+void setup(Position* pos);
+void printBoard(Position* pos);
+int readNotation(Position* pos, const char* text, int* whichplayer);//set up a position like 1TT1TT1/7/XX3XX/7/xx3xx/7/1tt1tt1 h 00 -, returns 0 if it isn't one
+void writeNotation(Position* pos, int whichplayer, char* text);//the other way around
+
+void setupBitboards(Position* pos);//build the piece bitboards, square map, zobrist key and evaluation from piecepositions
+bitboard slideAttacks(int square, int direction, bitboard empty);//the empty squares along a direction, plus the first blocker
+void addTargets(SearchContext* ctx, int piecesquare, bitboard targets, bitboard enemies, int direction, int curdepth, int piecenum, Move flags);//put the target squares on the list of legal moves
+void legalXWing(Position* pos, SearchContext* ctx, int piecenum, int curdepth, int capturesonly);//add all the valid moves of an x wing.  Only captures and death star hits if capturesonly is 1.
+void legalTieFighter(Position* pos, SearchContext* ctx, int piecenum, int curdepth, int capturesonly);//add all the valid moves of a tie fighter
+int checkGameOver(Position* pos);
+int checkNoMoves(SearchContext* ctx, int whichplayer, int curdepth);
+
+void findHumanMoves(Position* pos, SearchContext* ctx, int curdepth);//find a list of valid human moves
+void findComputerMoves(Position* pos, SearchContext* ctx, int curdepth);//find a list of valid computer moves
+void findCaptures(Position* pos, SearchContext* ctx, int whichplayer, int curdepth);//find only the captures and death star hits
+int checkListOfMoves(SearchContext* ctx, int from, int to);//check the human move with the list of available human moves.
+void showListOfMoves(Position* pos, SearchContext* ctx, int curdepth);
+void showAllMoves(Position* pos, SearchContext* ctx);//show all moves stored after a turn.
+void showNewMovesOnBoard(Position* pos, int newx, int newy);//debugging
+void cleanBoard(Position* pos);
+//void showPieces();//show all pieces
+//void showListStack(int curdepth);//show the list stack.
 
-void movePiece(int curdepth, int piecenum);
-void resetPiecePosition( int whichplayer, int curdepth, int piecenum);
-int checkPieceRemoved(int curdepth, int piecenum);
+bitboard positionKey(Position* pos, int computertomove);//the zobrist key of the position, with the side to move and the horizontal tie values
+bitboard packTransposition(int score, int remainingdepth, int bound, int bestfrom, int bestto);//pack a table entry's data into 64 bits
+int probeTransposition(bitboard key, int curdepth, int* remainingdepth, int* score, int* bound, int* bestfrom, int* bestto);//look up a position, returns 1 if found
+void storeTransposition(bitboard key, int curdepth, int remainingdepth, int score, int bound, int bestfrom, int bestto);//remember a searched position
+void clearTransposition();//forget every position, and start the generations over
+void orderMoves(Position* pos, SearchContext* ctx, int curdepth, int bestfrom, int bestto);//sort the list of moves, best looking first
+void rememberCutoff(SearchContext* ctx, int curdepth, int movecounter);//update the killer moves and history table for a move that caused a cutoff
+void ageHistory(SearchContext* ctx);//halve the history table, so newer cutoffs count more
+
+int evaluate(Position* pos, int curdepth);//evaluate the heuristic value.
+int negamax(Position* pos, SearchContext* ctx, int curdepth, int alpha, int beta, int whichplayer);//alpha beta search, scored for the player to move
+int quiesce(Position* pos, SearchContext* ctx, int curdepth, int alpha, int beta, int whichplayer);//quiescence search past the search depth:  only captures and death star hits
+int searchRoot(Position* pos, SearchContext* ctx, int whichplayer, int alpha, int beta, int* bestmove);//search the player's moves at depth 0
+int makeAMove(Position* pos, SearchContext* ctx);
+void searchWithHelpers(Position* pos, SearchContext* ctx, int whichplayer, SearchResult* result, int firstdepth);//searchMoves, with the helper threads
+void searchMoves(Position* pos, SearchContext* ctx, int whichplayer, SearchResult* result, int firstdepth);//iterative deepening over the player's moves at depth 0
+void playListedMove(Position* pos, SearchContext* ctx, int movecounter);//really make a move from the list at depth 0
+long long elapsedMilliseconds(SearchContext* ctx);//how long the current search has taken
+int checkTimeUp(SearchContext* ctx);//counts the node, and every so often sees if the search is out of time
+void playHumanReply(Position* pos, SearchContext* ctx, Move reply);//make a human move from a saved list of moves, the way main does
+void ponder();//the ponder thread
+void startPondering(Position* pos);//hand a copy of the position to the ponder thread
+void stopPondering();
+void helpSearch(int threadnum, const SearchContext* parent);//a Lazy SMP helper thread
+int canSplit(SearchContext* ctx, int curdepth);//1 if the node's moves after the first should be searched in parallel
+int checkSplitCutoff(SplitPoint* split);//1 if this split point, or one above it, was cut off
+int isUnderSplit(SplitPoint* split, SplitPoint* ancestor);
+void splitSearch(Position* pos, SearchContext* ctx, int curdepth, int whichplayer, int firstmove, int alpha, int beta, int* best, int* bestmove);//search the node's remaining moves in parallel
+void searchSplitMove(SearchContext* ctx, SplitPoint* split, int movecounter);//search one move of a split point
+int stealWork(SearchContext* ctx, SplitPoint* helping);//search a move from another thread's split point, returns 1 if there was one
+void workerSearch(int threadnum, const SearchContext* parent);//a Young Brothers Wait worker thread
+int findListedMove(SearchContext* ctx, const SearchResult* result);//where the result's move is in the list of moves at depth 0
+void addSearchStats(SearchStats* total, const SearchStats* part);//add one search's stats to another's
+void printStatsJson(const SearchStats* stats, const SearchResult* result, long long nodes);//one line of JSON with the move's search stats
+int selfPlayGame(Position* pos, SearchContext* ctx, int gamenum, SelfPlayStats* stats);//play one game, returns the winner or -1 for a draw
+void selfPlayWorker(SelfPlayStats* stats);//a self play thread
+void runSelfPlay();//play the self play games and print the summary
+int playMoveString(Position* pos, SearchContext* ctx, int whichplayer, const char* text);//make a move like B3C4, returns 0 if it isn't legal
+long long perft(Position* pos, SearchContext* ctx, int curdepth, int depth, int whichplayer);//count the positions depth plies ahead
+void perftWorker(const Position* root, int whichplayer, int depth, const Move* rootmoves, int numofrootmoves, long long* counts);//a perft thread
+long long countPerft(Position* pos, SearchContext* ctx, int whichplayer, int depth, Move* rootmoves, long long* counts, int* numofrootmoves);//perft over the threads
+void runPerft(Position* pos, SearchContext* ctx, int whichplayer);//count and time each depth up to perftdepth
+int runPerftSuite();//check the counts of the suite positions, and return how many were wrong
+void runBench();//search the bench positions and print the node count signature
+template <typename Pass> void timeKernel(const char* name, Pass pass);//time one kernel, and print the time per call
+void runMicrobench();//time each kernel over the bench positions and the ones near them
+long long tablebaseSize(const int counts[4]);//how many positions a table with these piece counts has
+long long tablebaseIndex(Position* pos, int whichplayer);//the position's place in its table, or -1 if a piece is on a death star
+int setupTablebasePosition(Position* pos, const int counts[4], long long index, int* whichplayer);//the other way around, returns 0 if two pieces share a square
+int probeTablebase(Position* pos, int whichplayer, int curdepth, int* score);//returns 1 and the exact score if the position is in a loaded table
+int solveTablebasePosition(Position* pos, SearchContext* ctx, int whichplayer, const unsigned char* values, int distance);//the value if it is decided at this distance, 0 if not yet
+void tablebaseWorker(const int* counts, unsigned char* values, const unsigned char* previous, int distance, long long* solved);//a generator thread
+void generateTablebase(const int counts[4]);//solve one table, write it and load it
+int loadTablebase(const int counts[4]);//map one table's file, returns 1 if it is there
+void loadTablebases();//map every table that is on disk
+void runTablebaseGeneration();//generate every missing table up to tbgenerate pieces
+int probeBook(SearchContext* ctx, bitboard key, SearchResult* result);//returns 1 and the book's move if the position is in the book
+void addBookLines(Position* pos, SearchContext* ctx, int whichplayer, int bookside, int pliesleft, map<bitboard, BookEntry>* entries);//search the positions for the book
+void runBookGeneration();//build the book and write it
+void loadBook();//map the book, if there is one
+void moveText(Move move, char* text);//write a move like B3C4
+int writeScore(int score, char* text, int size);//score 3, score win 5 or score loss 4
+int writePrincipalVariation(Position* pos, SearchContext* pvctx, int whichplayer, const SearchResult* result, char* text, int size);//pv B3C4 F5E4 ...
+void printSearchInfo(Position* pos, SearchContext* ctx, int whichplayer, const SearchResult* result);//the protocol's info line for a finished depth
+void protocolSearch();//the thread go starts
+void stopProtocolSearch();//stop it, and wait for its best move
+void waitProtocolSearch();//let it finish, and wait for its best move
+void setProtocolPosition();//read the rest of a position command
+void startProtocolSearch();//read the rest of a go command, and start the search
+void runProtocol();//answer the protocol's commands until quit
+long long analysePosition(Position* pos, SearchContext* ctx, const char* line, char* output);//search one line's position, returns the nodes
+void analysisWorker(long long* nodes);//an analysis thread
+void analysisWriter(FILE* file);//writes the results in order
+void runAnalysis();//analyse every position in analysisinput
+
+int getHumanMove(Position* pos, SearchContext* ctx);
+
+void movePiece(Position* pos, SearchContext* ctx, int curdepth);//make the move on the stack at curdepth
+void resetPiecePosition(Position* pos, SearchContext* ctx, int curdepth);//undo it
+int checkPieceRemoved(Position* pos, SearchContext* ctx, int curdepth);
 
-void doubleCaptureIndicators();//double the capture indicators so that when a move is undone, it doesn't undo a piece being captured that it shouldn't.
 
 
 //simple evaluate:  just return 0.  See ply effectiveness.
@@ -201,22 +761,9 @@ void doubleCaptureIndicators();//double the capture indicators so that when a mo
 
 //evaluate only based on pieces captured over the course of the match.
 //so far, the most effective.
-int evaluate(int curdepth)
-{
-    int pieceadvantage = 0;//the piece advantage.
-	//cout << moveadvantage << "\n";//debug
-	for (int piececounter = 0; piececounter < NUMOFPIECES*4; piececounter++)
-	{//look at the pieces captured.
-		if (capturedpieces[piececounter] != 0 && piececounter < 8)
-		{//if a human piece was captured
-			pieceadvantage++;//AI is happy:  increase the value
-		}
-		else if (capturedpieces[piececounter] != 0 && piececounter >= 8)
-		{//if a computer piece was captured
-			pieceadvantage-=2;
-		}
-	}
-    return pieceadvantage;
+int evaluate(Position* pos, int curdepth)
+{//the piece advantage.  checkPieceRemoved and resetPiecePosition keep it up to date, so there's nothing to count here.
+    return pos->evaluation;
 }
 
 //evaluate only based on the pieces captured in this minimax iteration.  previous iterations don't matter.
@@ -379,16 +926,213 @@ int evaluate(int curdepth)
 
 
 
-int main()
+int main(int argc, char* argv[])
 {//Start here
-    setup();//initialize the board
-    printBoard();//show the board state
+	for (int argcounter = 1; argcounter + 1 < argc; argcounter = argcounter + 2)
+	{//KaizoTrap -time <milliseconds per move> -depth <deepest search> -ponder <1 or 0> -threads <threads per search> -parallel <lazy or ybw> -delta <1 or 0>
+		if (strcmp(argv[argcounter], "-time") == 0)
+		{
+			movetime = atoi(argv[argcounter + 1]);
+		}
+		else if (strcmp(argv[argcounter], "-depth") == 0)
+		{
+			maxsearchdepth = min(max(atoi(argv[argcounter + 1]), 1), MAXDEPTH);
+		}
+		else if (strcmp(argv[argcounter], "-ponder") == 0)
+		{
+			ponderenabled = atoi(argv[argcounter + 1]);
+		}
+		else if (strcmp(argv[argcounter], "-threads") == 0)
+		{
+			numofthreads = min(max(atoi(argv[argcounter + 1]), 1), MAXTHREADS);
+		}
+		else if (strcmp(argv[argcounter], "-delta") == 0)
+		{
+			deltapruning = atoi(argv[argcounter + 1]);
+		}
+		else if (strcmp(argv[argcounter], "-json") == 0)
+		{
+			jsonstats = atoi(argv[argcounter + 1]);
+		}
+		else if (strcmp(argv[argcounter], "-parallel") == 0)
+		{//lazy (every thread searches the whole tree) or ybw (threads split up the moves of each node)
+			parallelmode = strcmp(argv[argcounter + 1], "ybw") == 0 ? YOUNGBROTHERSWAIT : LAZYSMP;
+		}
+		else if (strcmp(argv[argcounter], "-selfplay") == 0)
+		{//KaizoTrap -selfplay <games> -workers <games at once> -openingplies <random plies> -seed <number> -humantime/-computertime <ms> -humandepth/-computerdepth <plies>
+			selfplaygames = max(atoi(argv[argcounter + 1]), 0);
+		}
+		else if (strcmp(argv[argcounter], "-workers") == 0)
+		{//games at once for -selfplay, positions at once for -analyse
+			selfplayworkers = min(max(atoi(argv[argcounter + 1]), 1), MAXTHREADS);
+		}
+		else if (strcmp(argv[argcounter], "-openingplies") == 0)
+		{
+			openingplies = max(atoi(argv[argcounter + 1]), 0);
+		}
+		else if (strcmp(argv[argcounter], "-seed") == 0)
+		{
+			selfplayseed = strtoull(argv[argcounter + 1], NULL, 10);
+		}
+		else if (strcmp(argv[argcounter], "-humantime") == 0 || strcmp(argv[argcounter], "-computertime") == 0)
+		{
+			sidetime[argv[argcounter][1] == 'c'] = atoi(argv[argcounter + 1]);
+		}
+		else if (strcmp(argv[argcounter], "-humandepth") == 0 || strcmp(argv[argcounter], "-computerdepth") == 0)
+		{
+			sidedepth[argv[argcounter][1] == 'c'] = min(max(atoi(argv[argcounter + 1]), 1), MAXDEPTH);
+		}
+		else if (strcmp(argv[argcounter], "-bench") == 0)
+		{//KaizoTrap -bench 1 -benchdepth <depth>
+			runbench = atoi(argv[argcounter + 1]);
+		}
+		else if (strcmp(argv[argcounter], "-microbench") == 0)
+		{//KaizoTrap -microbench 1, or make bench-micro
+			runmicrobench = atoi(argv[argcounter + 1]);
+		}
+		else if (strcmp(argv[argcounter], "-benchdepth") == 0)
+		{
+			benchdepth = min(max(atoi(argv[argcounter + 1]), 1), MAXDEPTH);
+		}
+		else if (strcmp(argv[argcounter], "-perft") == 0)
+		{//KaizoTrap -perft <depth> -divide <1 or 0> -first <human or computer> -position "<notation>" -moves "<moves from there>" -threads <threads>
+			perftdepth = min(max(atoi(argv[argcounter + 1]), 0), MAXDEPTH - 1);
+		}
+		else if (strcmp(argv[argcounter], "-perftsuite") == 0)
+		{//KaizoTrap -perftsuite 1 -threads <threads>, or make perft-suite
+			runperftsuite = atoi(argv[argcounter + 1]);
+		}
+		else if (strcmp(argv[argcounter], "-divide") == 0)
+		{
+			perftdivide = atoi(argv[argcounter + 1]);
+		}
+		else if (strcmp(argv[argcounter], "-first") == 0)
+		{
+			perftfirst = strcmp(argv[argcounter + 1], "computer") == 0;
+		}
+		else if (strcmp(argv[argcounter], "-moves") == 0)
+		{
+			perftmoves = argv[argcounter + 1];
+		}
+		else if (strcmp(argv[argcounter], "-position") == 0)
+		{
+			perftposition = argv[argcounter + 1];
+		}
+		else if (strcmp(argv[argcounter], "-tbgen") == 0)
+		{//KaizoTrap -tbgen <most pieces> -tbpath <directory> -threads <threads>
+			tbgenerate = min(max(atoi(argv[argcounter + 1]), 0), TBMAXPIECES);
+		}
+		else if (strcmp(argv[argcounter], "-tbpath") == 0)
+		{
+			tbpath = argv[argcounter + 1];
+		}
+		else if (strcmp(argv[argcounter], "-bookgen") == 0)
+		{//KaizoTrap -bookgen <plies> -bookdepth <search depth> -book <file>
+			bookplies = max(atoi(argv[argcounter + 1]), 0);
+		}
+		else if (strcmp(argv[argcounter], "-bookdepth") == 0)
+		{
+			bookdepth = min(max(atoi(argv[argcounter + 1]), 1), MAXDEPTH);
+		}
+		else if (strcmp(argv[argcounter], "-book") == 0)
+		{
+			bookpath = argv[argcounter + 1];
+		}
+		else if (strcmp(argv[argcounter], "-analyse") == 0)
+		{//KaizoTrap -analyse <file of positions> -analysisoutput <file> -workers <positions at once> -depth <plies> -nodes <nodes>
+			analysisinput = argv[argcounter + 1];
+		}
+		else if (strcmp(argv[argcounter], "-analysisoutput") == 0)
+		{
+			analysisoutput = argv[argcounter + 1];
+		}
+		else if (strcmp(argv[argcounter], "-nodes") == 0)
+		{
+			analysisnodes = max(atoll(argv[argcounter + 1]), 0LL);
+		}
+		else if (strcmp(argv[argcounter], "-protocol") == 0)
+		{//KaizoTrap -protocol 1 -threads <threads>.  -time and -depth are used when go doesn't say.
+			protocolmode = atoi(argv[argcounter + 1]);
+		}
+	}
+	if (runbench == 1)
+	{//before the tablebases and the book are loaded, so what's on disk can't change the count.
+		runBench();
+		return 0;
+	}
+	if (runmicrobench == 1)
+	{
+		runMicrobench();
+		return 0;
+	}
+	loadTablebases();
+	if (tbgenerate > 0)
+	{//solve the endgames, instead of playing.
+		runTablebaseGeneration();
+		return 0;
+	}
+	if (bookplies > 0)
+	{//search the openings, instead of playing.  The book isn't loaded, since it is about to be written over.
+		runBookGeneration();
+		return 0;
+	}
+	loadBook();
+	if (runperftsuite == 1)
+	{//check the move generator against the known counts, instead of playing.  Fails the run if any are wrong.
+		return runPerftSuite() > 0;
+	}
+	if (perftdepth > 0)
+	{//count positions from the start position, after the -moves, instead of playing.
+		Position position = {};
+		SearchContext context = {};
+		setup(&position);
+		int whichplayer = perftfirst;
+		if (perftposition != NULL && readNotation(&position, perftposition, &whichplayer) == 0)
+		{
+			cout << "not a position:  " << perftposition << "\n";
+			return 1;
+		}
+		char movelist[1024];
+		snprintf(movelist, sizeof(movelist), "%s", perftmoves);
+		for (char* move = strtok(movelist, " ,"); move != NULL; move = strtok(NULL, " ,"))
+		{
+			if (playMoveString(&position, &context, whichplayer, move) == 0)
+			{
+				cout << "illegal move " << move << "\n";
+				return 1;
+			}
+			whichplayer = 1 - whichplayer;
+		}
+		runPerft(&position, &context, whichplayer);
+		return 0;
+	}
+	if (selfplaygames > 0)
+	{//no human:  just play the games and say how it went.
+		runSelfPlay();
+		return 0;
+	}
+	if (analysisinput != NULL)
+	{//search a file of positions, instead of playing.
+		runAnalysis();
+		return 0;
+	}
+	if (protocolmode == 1)
+	{//a GUI or tournament manager is playing:  no board, no prompts.
+		runProtocol();
+		return 0;
+	}
+	Position game = {};//the game being played.  The engine only ever sees it through these two pointers.
+	SearchContext context = {};
+	Position* pos = &game;
+	SearchContext* ctx = &context;
+	ctx->movetime = movetime;
+	ctx->maxsearchdepth = maxsearchdepth;
+    setup(pos);//initialize the board
+    printBoard(pos);//show the board state
     int humanmessedup = 1;//indicates if the human messed up, and the human's turn.
-    captureindicator = 1;//initially, no pieces are captured.
-	humanmovenum = 0;//to see if human tried to make a horizontal tie move.
     //start at 1, we put into the list:  the indicator decrements if a piece is unremoved
-	horizontalhuman = 0;
-	horizontalcomputer = 0;
+	pos->horizontalhuman = 0;
+	pos->horizontalcomputer = 0;
 	
     cout << "Would you like to go first?  Enter -1 If you do, and 0 if you don't:  ";
     scanf("%d", &humanmessedup);//might as well use the humanmessedup value.
@@ -396,16 +1140,19 @@ int main()
 	int start = humanmessedup;
     for(;;)
     {//Start the game, and keep playing
-		horizontalhuman = horizontalhuman - 1;//pretend to decrement.
-		cout << "horizontalhuman is currently " << horizontalhuman << "\n";
-		horizontalmovenum[0] = 0;//reset counter.  
+		cout << "horizontalhuman is currently " << pos->horizontalhuman << "\n";
+		if (ponderenabled == 1 && humanmessedup == -1)
+		{//think on the human's time
+			startPondering(pos);
+		}
         while (humanmessedup == -1)
         {//while the person keeps messing up
 		    //printBoard();//print the new board state, or remind person of current board state.
             
-            humanmessedup = getHumanMove();//get the human's move.
+            humanmessedup = getHumanMove(pos, ctx);//get the human's move.
             fflush(stdout);//to flush any outputs.
         }
+		stopPondering();//the human moved:  makeAMove picks up what the ponder thread found.
         //Here, I assume the user inputted a valid play, so I now update the board state
         
         
@@ -415,42 +1162,34 @@ int main()
 		}
 		else
 		{
-			movePiece( 0, humanmessedup);//This is a true move.  The stack should have the move to make
-			//the humanmessedup variable also acts as a piecenum variable, passed from checklistofmoves.
-			//cout << "Movestack at main is " << char(movestack[4]) << "\n";//debug
-			//cout << "Humanmovenum at main is " << humanmovenum << "\n";
-			if (char(movestack[4]) == 't' && checkListOfHorizontalMoves(humanmovenum , 0) == 1 && horizontalhuman != 1)
-			{//if this was a horizontal move, pretend it was one by setting the horizontal value.
-				//TODO FIX THIS SO IT DOESN'T DO THIS AFTER MAKING THE FIRST VERTICAL MOVE, FOR SOME REASON.
-				//No seriously, fix this.
-				cout << "Human made a horizontal move.  Set value to 2.  humanmovenum = " << humanmovenum << "\n";
-				horizontalhuman = 2;
+			movePiece(pos, ctx, 0);//This is a true move.  The stack should have the move to make, put there by checklistofmoves.
+			if (ctx->movestack[0] & MOVEHORIZONTAL)
+			{//movePiece already set the horizontal value.
+				cout << "Human made a horizontal move.  Set value to 2.\n";
 			}
 		}	
 		
-        doubleCaptureIndicators();
 		//cleanBoard();//clean board before showing updated board state
-	    printBoard();//show updated state
+	    printBoard(pos);//show updated state
 
-        if (checkGameOver() == 1)
+        if (checkGameOver(pos) == 1)
 		{
             cout << " Game Over:  You win\n";
 			exit(0);
 		}
         //AI's turn:  Determine best play
 		//cout << "Horizontal human ! is now " << horizontalhuman << "\n";//debug
-        makeAMove();
+        makeAMove(pos, ctx);
 		//cout << "Horizontal human ! is now " << horizontalhuman << "\n";//debug
 
-        doubleCaptureIndicators();
         //update board state
         //display board and announce move
 		//cout << "Horizontal human is now " << horizontalhuman << "\n";
 
 		//cleanBoard();//clean board after, to show the computer's possible moves.		
-        printBoard();
+        printBoard(pos);
         //check if game over.
-		if (checkGameOver() == 1)
+		if (checkGameOver(pos) == 1)
 		{
             cout << "Game Over:  I Win\n";
 			exit(0);
@@ -462,7 +1201,7 @@ int main()
 }
 
 
-void setup()
+void setup(Position* pos)
 {//Set up the initial board state:
     /*
     
@@ -476,131 +1215,168 @@ void setup()
        A B C D E F G
     */
 
-    //Hypothetically, since this is an array of strings, I could initialize it as such.
-    //More hypothetically, I can change the positions array to hold one element per object,
-	//since the board is now one dimensional.
-	
+	int whichplayer;
+	readNotation(pos, STARTNOTATION, &whichplayer);//laid out the same way as any other position.  Whoever goes first is up to the caller.
+}
 
-	piecepositions[0] = 4;//list of human x wings, start with y pos then x pos
-	piecepositions[1] = 0;
-	piecepositions[2] = 4;
-	piecepositions[3] = 1;
-	piecepositions[4] = 4;
-	piecepositions[5] = 5;
-	piecepositions[6] = 4;
-	piecepositions[7] = 6;
-	
-    piecepositions[8] = 6;//list of human tie fighters
-	piecepositions[9] = 1;
-	piecepositions[10] = 6;
-	piecepositions[11] = 2;
-	piecepositions[12] = 6;
-	piecepositions[13] = 4;
-	piecepositions[14] = 6;
-	piecepositions[15] = 5;
-	
-	
-	
-	piecepositions[16] = 2;//list of computer x wings
-	piecepositions[17] = 0;
-	piecepositions[18] = 2;
-	piecepositions[19] = 1;
-	piecepositions[20] = 2;
-	piecepositions[21] = 5;
-	piecepositions[22] = 2;
-	piecepositions[23] = 6;
-		
-	piecepositions[24] = 0;//list of computer tie fighters
-	piecepositions[25] = 1;
-	piecepositions[26] = 0;
-	piecepositions[27] = 2;
-	piecepositions[28] = 0;
-	piecepositions[29] = 4;
-	piecepositions[30] = 0;
-	piecepositions[31] = 5;
+int readNotation(Position* pos, const char* text, int* whichplayer)
+{//set up the position a notation string describes.  pos and whichplayer aren't touched if it isn't a position.
+	//<rows 7 to 1, split by /> <h or c to move> <human then computer horizontal values> <captured pieces, or ->
+	//In a row, x t X T are pieces, and a digit is that many squares with no piece on them.  The walls and death stars are always there,
+	//so they count as empty, and no piece can be on them:  A piece on a death star would be a game that's already over.  Each type's
+	//pieces get their piecenums in square order, the way setup always had them, and the captured ones are the rest.  The captured pieces
+	//have to make each type up to NUMOFPIECES, so a typo doesn't give a different position.
+	Position position = {};
+	memset(position.boardarray, EMPTYCHAR, sizeof(position.boardarray));
+	position.boardarray[9] = '~';//Computer Wall
+	position.boardarray[10] = '*';//Computer Death Star
+	position.boardarray[11] = '~';
+	position.boardarray[37] = '+';//Human Wall
+	position.boardarray[38] = '@';//Human Death Star
+	position.boardarray[39] = '+';
+	int counts[4] = {0, 0, 0, 0};//pieces on the board, by type
+	int x = 0;
+	int y = 0;
+	const char* character = text;
+	for (; *character != ' ' && *character != '\0'; character++)
+	{
+		if (*character == '/')
+		{//next row
+			if (x != XWIDTH || y == YWIDTH - 1)
+			{
+				return 0;
+			}
+			x = 0;
+			y++;
+		}
+		else if (*character >= '1' && *character <= '0' + XWIDTH)
+		{
+			x += *character - '0';
+			if (x > XWIDTH)
+			{
+				return 0;
+			}
+		}
+		else
+		{
+			const char* piecechar = (const char*)memchr(PIECECHARS, *character, 4);
+			int square = y*XWIDTH + x;
+			if (piecechar == NULL || x == XWIDTH || (((WALLBOARD | COMPUTERDEATHSTAR | HUMANDEATHSTAR) >> square) & 1) == 1 
+				|| counts[piecechar - PIECECHARS] == NUMOFPIECES)
+			{
+				return 0;
+			}
+			int piecenum = (piecechar - PIECECHARS)*NUMOFPIECES + counts[piecechar - PIECECHARS]++;
+			position.piecepositions[piecenum*2] = y;
+			position.piecepositions[piecenum*2+1] = x;
+			position.boardarray[square] = *character;
+			x++;
+		}
+	}
+	if (x != XWIDTH || y != YWIDTH - 1 || character[0] != ' ' || (character[1] != 'h' && character[1] != 'c') || character[2] != ' '
+		|| character[3] < '0' || character[3] > '2' || character[4] < '0' || character[4] > '2' || character[5] != ' ')
+	{
+		return 0;
+	}
+	position.horizontalhuman = character[3] - '0';
+	position.horizontalcomputer = character[4] - '0';
+	int player = character[1] == 'c';
 	
-    boardarray[0] = EMPTYCHAR;//blank space
-    boardarray[1] = 'T';//Computer Tie Fighter.
-    boardarray[2] = 'T';//Computer Tie Fighter.
-    boardarray[3] = EMPTYCHAR;
-    boardarray[4] = 'T';//Computer Tie Fighter.
-    boardarray[5] = 'T';//Computer Tie Fighter.
-    boardarray[6] = EMPTYCHAR;
-        		
-    boardarray[7] = EMPTYCHAR;
-    boardarray[8] = EMPTYCHAR;
-    boardarray[9] = '~';//Computer Wall
-    boardarray[10] = '*';//Computer Death Star
-    boardarray[11] = '~';//Computer Wall
-    boardarray[12] = EMPTYCHAR;
-    boardarray[13] = EMPTYCHAR;
-                    
-    boardarray[14] = 'X';//Computer X wing
-    boardarray[15] = 'X';//Computer X wing
-    boardarray[16] = EMPTYCHAR;
-    boardarray[17] = EMPTYCHAR;
-    boardarray[18] = EMPTYCHAR;
-    boardarray[19] = 'X';//Computer X wing
-    boardarray[20] = 'X';//Computer X wing
-    
-    boardarray[21] = EMPTYCHAR;
-    boardarray[22] = EMPTYCHAR;
-    boardarray[23] = EMPTYCHAR;
-    boardarray[24] = EMPTYCHAR;
-    boardarray[25] = EMPTYCHAR;
-    boardarray[26] = EMPTYCHAR;
-    boardarray[27] = EMPTYCHAR;
-    
-    boardarray[28] = 'x';//Human X wing
-    boardarray[29] = 'x';//Human X wing
-    boardarray[30] = EMPTYCHAR;
-    boardarray[31] = EMPTYCHAR;
-    boardarray[32] = EMPTYCHAR;
-    boardarray[33] = 'x';//Human X wing
-    boardarray[34] = 'x';//Human X wing
-        
-    boardarray[35] = EMPTYCHAR;
-    boardarray[36] = EMPTYCHAR;
-    boardarray[37] = '+';//Human Wall
-    boardarray[38] = '@';//Human Death Star
-    boardarray[39] = '+';//Human Wall
-    boardarray[40] = EMPTYCHAR;
-    boardarray[41] = EMPTYCHAR;
-    
-    boardarray[42] = EMPTYCHAR;//blank space
-    boardarray[43] = 't';//Human Tie Fighter.
-    boardarray[44] = 't';//Human Tie Fighter.
-    boardarray[45] = EMPTYCHAR;
-    boardarray[46] = 't';//Human Tie Fighter.
-    boardarray[47] = 't';//Human Tie Fighter.
-    boardarray[48] = EMPTYCHAR;
-    
-    
-    for (int counter = 0; counter < NUMOFPIECES*4; counter++)
-    {
-        capturedpieces[counter] = 0;
-    }
-    
-    
-    
+	int captured[4] = {0, 0, 0, 0};
+	character += 6;
+	if (*character == '-')
+	{
+		character++;
+	}
+	for (; *character != '\0' && *character != ' ' && *character != '\r' && *character != '\n'; character++)
+	{
+		const char* piecechar = (const char*)memchr(PIECECHARS, *character, 4);
+		if (piecechar == NULL)
+		{
+			return 0;
+		}
+		captured[piecechar - PIECECHARS]++;
+	}
+	for (int piecetype = 0; piecetype < 4; piecetype++)
+	{
+		if (counts[piecetype] + captured[piecetype] != NUMOFPIECES)
+		{
+			return 0;
+		}
+		for (int piecenum = piecetype*NUMOFPIECES + counts[piecetype]; piecenum < (piecetype + 1)*NUMOFPIECES; piecenum++)
+		{
+			position.capturedpieces[piecenum] = 1;
+		}
+	}
+	setupBitboards(&position);
+	*pos = position;
+	*whichplayer = player;
+	return 1;
+}
+
+void writeNotation(Position* pos, int whichplayer, char* text)
+{//write the position the way readNotation reads it.  text needs room for NOTATIONSIZE characters.
+	char* character = text;
+	for (int y = 0; y < YWIDTH; y++)
+	{
+		int empty = 0;//squares with no piece since the last one
+		for (int x = 0; x < XWIDTH; x++)
+		{
+			int piecenum = pos->squarepieces[y*XWIDTH + x];
+			if (piecenum == NOPIECE)
+			{
+				empty++;
+				continue;
+			}
+			if (empty > 0)
+			{
+				*character++ = '0' + empty;
+				empty = 0;
+			}
+			*character++ = PIECECHARS[piecenum/NUMOFPIECES];
+		}
+		if (empty > 0)
+		{
+			*character++ = '0' + empty;
+		}
+		*character++ = y < YWIDTH - 1 ? '/' : ' ';
+	}
+	*character++ = whichplayer == 1 ? 'c' : 'h';
+	*character++ = ' ';
+	*character++ = '0' + pos->horizontalhuman;
+	*character++ = '0' + pos->horizontalcomputer;
+	*character++ = ' ';
+	char* capturedstart = character;
+	for (int piecenum = 0; piecenum < NUMOFPIECES*4; piecenum++)
+	{
+		if (pos->capturedpieces[piecenum] == 1)
+		{
+			*character++ = PIECECHARS[piecenum/NUMOFPIECES];
+		}
+	}
+	if (character == capturedstart)
+	{
+		*character++ = '-';
+	}
+	*character = '\0';
 }
 
-void printBoard()
+void printBoard(Position* pos)
 {//print out the current board state
     cout << endl;
-    cout << "7 " << boardarray[0] << " " <<  boardarray[1] << " " << boardarray[2] << " " << boardarray[3] << " " << boardarray[4] << " " << boardarray[5] << " " << boardarray[6] << "   COMPUTER";
+    cout << "7 " << pos->boardarray[0] << " " <<  pos->boardarray[1] << " " << pos->boardarray[2] << " " << pos->boardarray[3] << " " << pos->boardarray[4] << " " << pos->boardarray[5] << " " << pos->boardarray[6] << "   COMPUTER";
     printf("\n");//new lines, to make things look nice.
-	cout << "6 " << boardarray[7] << " " <<  boardarray[8] << " " << boardarray[9] << " " << boardarray[10] << " " << boardarray[11] << " " << boardarray[12] << " " << boardarray[13];
+	cout << "6 " << pos->boardarray[7] << " " <<  pos->boardarray[8] << " " << pos->boardarray[9] << " " << pos->boardarray[10] << " " << pos->boardarray[11] << " " << pos->boardarray[12] << " " << pos->boardarray[13];
     printf("\n");
-	cout << "5 " << boardarray[14] << " " <<  boardarray[15] << " " << boardarray[16] << " " << boardarray[17] << " " << boardarray[18] << " " << boardarray[19] << " " << boardarray[20];
+	cout << "5 " << pos->boardarray[14] << " " <<  pos->boardarray[15] << " " << pos->boardarray[16] << " " << pos->boardarray[17] << " " << pos->boardarray[18] << " " << pos->boardarray[19] << " " << pos->boardarray[20];
     printf("\n");    
-	cout << "4 " << boardarray[21] << " " <<  boardarray[22] << " " << boardarray[23] << " " << boardarray[24] << " " << boardarray[25] << " " << boardarray[26] << " " << boardarray[27];
+	cout << "4 " << pos->boardarray[21] << " " <<  pos->boardarray[22] << " " << pos->boardarray[23] << " " << pos->boardarray[24] << " " << pos->boardarray[25] << " " << pos->boardarray[26] << " " << pos->boardarray[27];
     printf("\n");
-	cout << "3 " << boardarray[28] << " " <<  boardarray[29] << " " << boardarray[30] << " " << boardarray[31] << " " << boardarray[32] << " " << boardarray[33] << " " << boardarray[34];
+	cout << "3 " << pos->boardarray[28] << " " <<  pos->boardarray[29] << " " << pos->boardarray[30] << " " << pos->boardarray[31] << " " << pos->boardarray[32] << " " << pos->boardarray[33] << " " << pos->boardarray[34];
     printf("\n");
-	cout << "2 " << boardarray[35] << " " <<  boardarray[36] << " " << boardarray[37] << " " << boardarray[38] << " " << boardarray[39] << " " << boardarray[40] << " " << boardarray[41];
+	cout << "2 " << pos->boardarray[35] << " " <<  pos->boardarray[36] << " " << pos->boardarray[37] << " " << pos->boardarray[38] << " " << pos->boardarray[39] << " " << pos->boardarray[40] << " " << pos->boardarray[41];
     printf("\n");    
-	cout << "1 " << boardarray[42] << " " <<  boardarray[43] << " " << boardarray[44] << " " << boardarray[45] << " " << boardarray[46] << " " << boardarray[47] << " " << boardarray[48] << "   HUMAN";
+	cout << "1 " << pos->boardarray[42] << " " <<  pos->boardarray[43] << " " << pos->boardarray[44] << " " << pos->boardarray[45] << " " << pos->boardarray[46] << " " << pos->boardarray[47] << " " << pos->boardarray[48] << "   HUMAN";
     printf("\n");
     cout << "  A B C D E F G";
     printf("\n\n");
@@ -608,492 +1384,149 @@ void printBoard()
 }
 
 
-int legalXWing(int piecetomovex, int piecetomovey, int piecenewx, int piecenewy, char piecetomove, int curdepth, int piecenum)
+void setupBitboards(Position* pos)
+{//build the bitboards, the square map, the zobrist key and the evaluation from the list of piece positions, so they all agree with each other.
+	for (int piecetype = 0; piecetype < 4; piecetype++)
+	{
+		pos->pieceboards[piecetype] = 0;
+	}
+	for (int square = 0; square < NUMOFSQUARES; square++)
+	{
+		pos->squarepieces[square] = NOPIECE;
+	}
+	pos->zobristkey = 0;
+	pos->evaluation = 0;
+	for (int piecenum = 0; piecenum < NUMOFPIECES*4; piecenum++)
+	{//put each piece that is still on the board on its type's bitboard, its square and the zobrist key.
+		if (pos->capturedpieces[piecenum] == 0)
+		{
+			int square = pos->piecepositions[piecenum*2]*YWIDTH + pos->piecepositions[piecenum*2+1];
+			pos->pieceboards[piecenum/NUMOFPIECES] |= 1ULL << square;
+			pos->squarepieces[square] = piecenum;
+			pos->zobristkey ^= zobrist.pieces[piecenum/NUMOFPIECES][square];
+		}
+		else
+		{
+			pos->evaluation += CAPTUREVALUES[piecenum/NUMOFPIECES];
+		}
+	}
+}
+
+bitboard slideAttacks(int square, int direction, bitboard empty)
+{//the squares a piece can slide to in a direction, plus the first square that isn't empty, if there is one.
+	bitboard ray = movetables.rays[direction][square];
+	bitboard blockers = ray & ~empty;
+	if (blockers == 0)
+	{//nothing in the way, the whole ray to the edge.
+		return ray;
+	}
+	int firstblocker = 0;
+	if (directionshift[direction] > 0)
+	{//the closest square has the lowest bit
+		firstblocker = __builtin_ctzll(blockers);
+	}
+	else
+	{//the closest square has the highest bit
+		firstblocker = 63 - __builtin_clzll(blockers);
+	}
+	return ray ^ movetables.rays[direction][firstblocker];//cut off everything behind the blocker.
+}
+
+void addTargets(SearchContext* ctx, int piecesquare, bitboard targets, bitboard enemies, int direction, int curdepth, int piecenum, Move flags)
+{//add a move for every target square, closest to the piece first, which is the order the old walk found them in.  flags is MOVEHORIZONTAL
+	//for sideways tie fighter moves.  The capture and death star flags are worked out here.
+	while (targets != 0)
+	{
+		int target = 0;
+		if (directionshift[direction] > 0)
+		{//the closest square has the lowest bit
+			target = __builtin_ctzll(targets);
+		}
+		else
+		{//the closest square has the highest bit
+			target = 63 - __builtin_clzll(targets);
+		}
+		targets &= ~(1ULL << target);
+		Move move = packMove(piecesquare, target, piecenum) | flags;
+		if ((enemies >> target) & 1)
+		{
+			move |= MOVECAPTURE;
+		}
+		else if (((COMPUTERDEATHSTAR | HUMANDEATHSTAR) >> target) & 1)
+		{//only the enemy's can be a target
+			move |= MOVEDEATHSTAR;
+		}
+		ctx->listoflegalmoves[LISTSIZE*curdepth + ctx->movenum[curdepth]] = move;//add it to list of legal moves to play, offset by movenum[curdepth].
+		ctx->movenum[curdepth]++;
+	}
+}
+
+void legalXWing(Position* pos, SearchContext* ctx, int piecenum, int curdepth, int capturesonly)
 {//the valid rules for moving an X Wing
     //1.  Moves diagonally.
     //2.  Can only move backwards if capturing an enemy piece.
     //3.  Can't jump above an occupied space.
-    
-
-    if (abs(piecetomovex - piecenewx) != abs(piecetomovey - piecenewy))
-    {//first, ensure that the piece moved diagonally (x and y delta are the same)
-        /*cout << "Invalid X Wing Move:  Not Diagonal.  Please enter valid move";
-        printf("\n");*/
-        return 1;
-    } 
+	//4.  Can only hit the death star from behind.
+	int piecesquare = pos->piecepositions[piecenum*2]*YWIDTH + pos->piecepositions[piecenum*2+1];
+	int side = piecenum/(NUMOFPIECES*2);//0 = human, 1 = computer
+	bitboard occupied = pos->pieceboards[0] | pos->pieceboards[1] | pos->pieceboards[2] | pos->pieceboards[3];
+	bitboard empty = FULLBOARD & ~(occupied | WALLBOARD | COMPUTERDEATHSTAR | HUMANDEATHSTAR);
+	bitboard enemies = pos->pieceboards[2 - side*2] | pos->pieceboards[3 - side*2];//the pieces this x wing can capture
+	//it can go to an empty square only in front of it, and hit the death star only from behind it.
+	bitboard targets = (empty & movetables.forward[side][piecesquare]) | enemies | movetables.deathstarhits[piecenum/NUMOFPIECES][piecesquare];
+	if (capturesonly == 1)
+	{
+		targets &= ~empty;
+	}
+	
+	for (int direction = UPLEFT; direction <= DOWNLEFT; direction++)
+	{//slide along each diagonal.  The slide stops at the first piece, so only that one can be captured.
+		addTargets(ctx, piecesquare, slideAttacks(piecesquare, direction, empty) & targets, enemies, direction, curdepth, piecenum, 0);
+	}
+}
 
-    //see which way is backwards for the piece.
-    int backstep = 0;//the step that is considered backwards, relative to the board's y axis
-    if (piecetomove == 'x')
-    {//if this is a human x wing
-        backstep = 1;
-    }
-    else if (piecetomove == 'X')
-    {//if this is a computer x wing
-        backstep = -1;
-    }
-    
-    
-    //Make sure the x wing doesn't jump over a piece
-	int xstep = 0;//step directions
-    int ystep = 0;
-    
-	if ( piecetomovex > piecenewx)
-    {
-        xstep = -1;
-    }
-    else
-    {
-        xstep = 1;
-    }
-	
-	if (piecetomovey > piecenewy)
-    {
-        ystep = -1;
-    }
-	else
-    {
-        ystep = 1;
-    }
-    
-	//So, cool thing is, The number of steps up or down is the same number of steps left or right.  So, I only have to check one condition.  Neat!
-	int curx = piecetomovex + xstep;//Might as well add one now, don't check the piece's original position.
-    int cury = piecetomovey + ystep;
-    for(;curx != piecenewx ; curx = curx + xstep)
-    {//Realization:  I don't care which one is checked, since both deltas are the same, ex. move up one left one, or up three right three.
-		if (boardarray[cury*YWIDTH + curx] == EMPTYCHAR || boardarray[cury*YWIDTH + curx] == MOVECHAR)
-        {//if the tie fighter didn't jump over or capture a piece
-            if (ystep != backstep)
-            {//if this piece isn't moving backwards, we can add this to a move.
-                listoflegalmoves[LISTSIZE*curdepth + movenum[curdepth]] = piecetomovex;//add old and new locations to list of legal moves to play.
-                listoflegalmoves[LISTSIZE*curdepth + movenum[curdepth]+1] = piecetomovey;//offset by movenum[curdepth].
-                listoflegalmoves[LISTSIZE*curdepth + movenum[curdepth]+2] = curx;//make sure we use the current step to add
-                listoflegalmoves[LISTSIZE*curdepth + movenum[curdepth]+3] = cury;
-                listoflegalmoves[LISTSIZE*curdepth + movenum[curdepth]+4] = piecenum;//the piece being moved.
-                /*cout << "Adding legal x wing move " << listoflegalmoves[movenum[curdepth]] << " " << listoflegalmoves[movenum[curdepth]+1] 
-                << " " << listoflegalmoves[movenum[curdepth]+2] << " " << listoflegalmoves[movenum[curdepth]+3] << " "<<"\n";
-                cout << "Adding legal x wing move (ASCII Mode)" << (char)(listoflegalmoves[movenum[curdepth]]+'A') << " " << (char)((YWIDTH - listoflegalmoves[movenum[curdepth]+1])+'0') 
-                << " " << (char)(listoflegalmoves[movenum[curdepth]+2]+'A') << " " << (char)((YWIDTH - listoflegalmoves[movenum[curdepth]+3])+'0') << " "<<"\n";
-                *///Debug        
-                movenum[curdepth] = movenum[curdepth] + 5;//offset based on number of elements per pseudo row. 
-            }                
-        } 
-        else if ((piecetomove == 'x' && (boardarray[YWIDTH*cury + curx] == 'X' || boardarray[YWIDTH*cury + curx] == 'T'))
-                || (piecetomove == 'X' && (boardarray[YWIDTH*cury + curx] == 'x' || boardarray[YWIDTH*cury + curx] == 't')))
-        {//if this piece is going to capture, add the move, but return after, since going after would jump over a piece.
-            //doesn't matter where from, if we got here, then it's fine to move forwards or backwards.
-            listoflegalmoves[LISTSIZE*curdepth + movenum[curdepth]] = piecetomovex;//add old and new locations to list of legal moves to play.
-            listoflegalmoves[LISTSIZE*curdepth + movenum[curdepth]+1] = piecetomovey;//offset by movenum[curdepth].
-            listoflegalmoves[LISTSIZE*curdepth + movenum[curdepth]+2] = curx;//make sure we use the current step to add
-            listoflegalmoves[LISTSIZE*curdepth + movenum[curdepth]+3] = cury;
-            listoflegalmoves[LISTSIZE*curdepth + movenum[curdepth]+4] = piecenum;//the piece being moved.
-            /*cout << "Adding legal x wing move " << listoflegalmoves[movenum[curdepth]] << " " << listoflegalmoves[movenum[curdepth]+1] 
-			<< " " << listoflegalmoves[movenum[curdepth]+2] << " " << listoflegalmoves[movenum[curdepth]+3] << " "<<"\n";
-            cout << "Adding legal x wing move (ASCII Mode)" << (char)(listoflegalmoves[movenum[curdepth]]+'A') << " " << (char)((YWIDTH - listoflegalmoves[movenum[curdepth]+1])+'0') 
-		    << " " << (char)(listoflegalmoves[movenum[curdepth]+2]+'A') << " " << (char)((YWIDTH - listoflegalmoves[movenum[curdepth]+3])+'0') << " "<<"\n";
-            *///Debug        
-            movenum[curdepth] = movenum[curdepth] + 5;//offset based on number of elements per pseudo row.           
-            return 0;
-        }
-        else if (piecetomove == 'x' && boardarray[YWIDTH*cury + curx] == '*' && ((piecetomovex == 2 || piecetomovex == 4) && piecetomovey == 0))
-        {//if this would capture a death star, add it.
-            listoflegalmoves[LISTSIZE*curdepth + movenum[curdepth]] = piecetomovex;//add old and new locations to list of legal moves to play.
-            listoflegalmoves[LISTSIZE*curdepth + movenum[curdepth]+1] = piecetomovey;//offset by movenum[curdepth].
-            listoflegalmoves[LISTSIZE*curdepth + movenum[curdepth]+2] = curx;//make sure we use the current step to add
-            listoflegalmoves[LISTSIZE*curdepth + movenum[curdepth]+3] = cury;
-            listoflegalmoves[LISTSIZE*curdepth + movenum[curdepth]+4] = piecenum;//the piece being moved.
-            /*cout << "Adding legal x wing move " << listoflegalmoves[movenum[curdepth]] << " " << listoflegalmoves[movenum[curdepth]+1] 
-			<< " " << listoflegalmoves[movenum[curdepth]+2] << " " << listoflegalmoves[movenum[curdepth]+3] << " "<<"\n";
-            cout << "Adding legal x wing move (ASCII Mode)" << (char)(listoflegalmoves[movenum[curdepth]]+'A') << " " << (char)((YWIDTH - listoflegalmoves[movenum[curdepth]+1])+'0') 
-		    << " " << (char)(listoflegalmoves[movenum[curdepth]+2]+'A') << " " << (char)((YWIDTH - listoflegalmoves[movenum[curdepth]+3])+'0') << " "<<"\n";
-            *///Debug        
-            movenum[curdepth] = movenum[curdepth] + 5;//offset based on number of elements per pseudo row.           
-            return 0;
-        }
-        else if (piecetomove == 'X'  && boardarray[YWIDTH*cury + curx] == '@' && ((piecetomovex == 2 || piecetomovex == 4) && piecetomovey == 6))
-        {
-            listoflegalmoves[LISTSIZE*curdepth + movenum[curdepth]] = piecetomovex;//add old and new locations to list of legal moves to play.
-            listoflegalmoves[LISTSIZE*curdepth + movenum[curdepth]+1] = piecetomovey;//offset by movenum[curdepth].
-            listoflegalmoves[LISTSIZE*curdepth + movenum[curdepth]+2] = curx;//make sure we use the current step to add
-            listoflegalmoves[LISTSIZE*curdepth + movenum[curdepth]+3] = cury;
-            listoflegalmoves[LISTSIZE*curdepth + movenum[curdepth]+4] = piecenum;//the piece being moved.
-            /*cout << "Adding legal x wing move " << listoflegalmoves[movenum[curdepth]] << " " << listoflegalmoves[movenum[curdepth]+1] 
-			<< " " << listoflegalmoves[movenum[curdepth]+2] << " " << listoflegalmoves[movenum[curdepth]+3] << " "<<"\n";
-            cout << "Adding legal x wing move (ASCII Mode)" << (char)(listoflegalmoves[movenum[curdepth]]+'A') << " " << (char)((YWIDTH - listoflegalmoves[movenum[curdepth]+1])+'0') 
-		    << " " << (char)(listoflegalmoves[movenum[curdepth]+2]+'A') << " " << (char)((YWIDTH - listoflegalmoves[movenum[curdepth]+3])+'0') << " "<<"\n";
-            *///Debug        
-            movenum[curdepth] = movenum[curdepth] + 5;//offset based on number of elements per pseudo row.           
-            return 0;
-        }
-        else
-        {//return 1 since they went to try to jump over a piece..
-            return 1;
-        }
-		cury = cury + ystep;//also include the increment of the ystep.
-    }
-	
-    
-    //last part, have to double check something, make sure it doesn't capture it's own piece.
-    if (piecetomove == 'x' && (boardarray[YWIDTH*piecenewy + piecenewx] == 'x' || boardarray[YWIDTH*piecenewy + piecenewx] == 't' ||
-		boardarray[YWIDTH*piecenewy + piecenewx] == '@'))
-    {//if the human's new location would capture it's own piece.
-        /*cout << "Invalid X Wing Move:  Can't capture one's piece.  Please enter a valid move.";
-		printf("\n");*/
-		return 1;
-    }
-     else if (piecetomove == 'X' && (boardarray[YWIDTH*piecenewy + piecenewx] == 'X' || boardarray[YWIDTH*piecenewy + piecenewx] == 'T' ||
-		boardarray[YWIDTH*piecenewy +piecenewx] == '*'))
-	{//if the computer's new location would capture it's own piece.
-		/*cout << "I (the computer) made an Invalid X Wing Move:  Can't capture one's piece.  Please enter a valid move.";
-		printf("\n");*/
-		return 1;
-	}
-    else if (ystep == backstep && ((piecetomove == 'x' && (boardarray[YWIDTH*piecenewy + piecenewx] != 'X' && boardarray[YWIDTH*piecenewy + piecenewx] != 'T'))
-            || (piecetomove == 'X' && (boardarray[YWIDTH*piecenewy + piecenewx] != 'x' && boardarray[YWIDTH*piecenewy + piecenewx] != 't'))))
-    {//if this went backwards without capturing at the end, exit without adding the move.
-        return 1;
-    }
-    
-	//here, assume we've made a correct move.
-    listoflegalmoves[LISTSIZE*curdepth + movenum[curdepth]] = piecetomovex;//add old and new locations to list of legal moves to play.
-	listoflegalmoves[LISTSIZE*curdepth + movenum[curdepth]+1] = piecetomovey;//offset by movenum[curdepth].
-	listoflegalmoves[LISTSIZE*curdepth + movenum[curdepth]+2] = piecenewx;//make sure we use the current step to add
-	listoflegalmoves[LISTSIZE*curdepth + movenum[curdepth]+3] = piecenewy;
-	listoflegalmoves[LISTSIZE*curdepth + movenum[curdepth]+4] = piecenum;//the piece being moved.
-    /*cout << "Adding legal x wing move " << listoflegalmoves[movenum[curdepth]] << " " << listoflegalmoves[movenum[curdepth]+1] 
-			<< " " << listoflegalmoves[movenum[curdepth]+2] << " " << listoflegalmoves[movenum[curdepth]+3] << " "<<"\n";
-	cout << "Adding legal x wing move (ASCII Mode)" << (char)(listoflegalmoves[movenum[curdepth]]+'A') << " " << (char)((YWIDTH - listoflegalmoves[movenum[curdepth]+1])+'0') 
-		    << " " << (char)(listoflegalmoves[movenum[curdepth]+2]+'A') << " " << (char)((YWIDTH - listoflegalmoves[movenum[curdepth]+3])+'0') << " "<<"\n";
-    *///Debug        
-    movenum[curdepth] = movenum[curdepth] + 5;//offset based on number of elements per pseudo row.
-    //Increment after showing the move, so we don't increment and see a bunch of '0's
-    return 0;//assume they made a right move.
-    
-}
-
-int legalTieFighter(int piecetomovex, int piecetomovey, int piecenewx, int piecenewy, char piecetomove, int curdepth, int piecenum)
+void legalTieFighter(Position* pos, SearchContext* ctx, int piecenum, int curdepth, int capturesonly)
 {//the valid rules for moving a TIE fighter
     //1.  Moves horizontally or vertically onto an empty space.
     //2.  Can only move sideways once every other turn.  Cannot move sideways twice in one turn.
     //3.  Can only move backwards if capturing an enemy piece.
     //4.  Can't jump above an occupied space.
-    int horizontalmove = 0;//indicates if the move was horizontal.  If so, add it to list of horizontal moves via movenum.
-	
-    
-    //see which way is backwards for the piece.
-    int backstep = 0;//the step that is considered backwards, relative to the board's y axis
-    if (piecetomove == 't')
-    {//if this is a human tie
-        backstep = 1;
-    }
-    else if (piecetomove == 'T')
-    {//if this is a computer tie
-        backstep = -1;
-    }
-       
-    
-    //deprecated:  findHumanmoves and findComputer moves makes it so it can only go vertical or horizontally.
-    /*if ((piecetomovex - piecenewx) != 0 && (piecetomovey - piecenewy) != 0)
-    {//first, ensure that the piece is moved horizontally or vertically (one of the deltas must be 0)
-        //cout << "Invalid Tie Fighter Move:  Not Horizontal or Vertical move.  Please enter valid move";
-        //printf("\n");
-        return 1;
-    }*/
-    
-
-	
-	
-   
-    int ystep = 0;//incrementer, declared here so the last step can utilize this.
-    
-    if (piecetomovey - piecenewy == 0)
-    {//horizontal move(No y delta)
-	
-		if (piecetomove == 't')
-		{//if this is the human's TIE fighter.
-			if (horizontalhuman >= 1)
-			{//if the tie fighter already moved horizontally last turn.
-				//cout << "A Tie fighter cannot move horizontally twice in a row.  Please enter a valid input.";
-				//printf("\n");
-				return 1;
-			} 
-			else
-			{//increase value to 2:  Always decremented each turn, including this one
-				//TODO figure out how to solve this
-				horizontalmove = 1;
-			}
-		} 
-		else if (piecetomove == 'T')
-		{//assuming it's the computer's TIE fighter.
-			if (horizontalcomputer >= 1)
-			{//if the tie fighter moved sideways last turn
-				//cout << "I (The computer) made an error:  A Tie fighter cannot move horizontally twice in a row.  Please enter a valid input.";
-				//printf("\n");
-				return 1;
-			}
-			else
-			{
-				horizontalmove = 1;
-			}          
-		} 
-			
-        int xstep = 0;//incrementer
-        if (piecetomovex > piecenewx)
-        {//setup counter to go from old point to new point, making incrementer negative if necessary
-			//cout << "piecetomovex > piecenewx.  piecetomovex = " << piecetomovex << " piecenewx = " << piecenewx << "\n";
-            xstep = -1;//trying to go to new piece, ex.  oldx = 6, newx = 4, go by -1
-        }
-        else
-        {
-			//cout << "piecetomovex < piecenewx.  piecetomovex = " << piecetomovex << " piecenewx = " << piecenewx << "\n";		
-            xstep = 1;
-        }
-        
-        int curx = piecetomovex + xstep;//initialize variable to be one off it's starting point, so it doesn't check itself.
-        /*we add by one so it doesn't check itself.  Also because if it moves by one step, 
-        //no need to check if it jumps, since it isn't jumping anything if it is just moving adjacently.*/
-        for ( ; curx != piecenewx; curx = curx + xstep)
-        {//increment the steps to the new position, only have to worry about the x axis
-			//I'm making it != so that it can work both for increment and decrement.
-            
-            /*cout << "Checking current x: " << curx;//DEBUG see xstep
-            printf("\n");*///debug
-            if (boardarray[YWIDTH*piecetomovey + curx] == EMPTYCHAR || boardarray[YWIDTH*piecetomovey + curx] == MOVECHAR )
-            {//if the tie fighter isn't jumping over a piece, or is capturing an enemy piece.
-                listoflegalmoves[LISTSIZE*curdepth + movenum[curdepth]] = piecetomovex;//add old and new locations to list of legal moves to play.
-                listoflegalmoves[LISTSIZE*curdepth + movenum[curdepth]+1] = piecetomovey;//offset by movenum[curdepth].
-                listoflegalmoves[LISTSIZE*curdepth + movenum[curdepth]+2] = curx;//make sure we use the current step to add
-                listoflegalmoves[LISTSIZE*curdepth + movenum[curdepth]+3] = piecenewy;
-                listoflegalmoves[LISTSIZE*curdepth + movenum[curdepth]+4] = piecenum;//the piece being moved.
-                //cout << "Adding horizontal tie move " << char(listoflegalmoves[movenum[curdepth]+0] + 'A')<< " " << char(YWIDTH - listoflegalmoves[movenum[curdepth]+1] + '0')
-				//	<< " " << char(listoflegalmoves[movenum[curdepth]+2] + 'A') << " " << char(YWIDTH - listoflegalmoves[movenum[curdepth]+3] + '0') << "\n";
-
-				listofhorizontaltiemoves[24*curdepth + horizontalmovenum[curdepth]] = movenum[curdepth];//put the movenumber that was horizontal, we can check it later.
-				//cout << "		listofhorizontaltiemoves[24*curdepth + blah] = " << movenum[curdepth] << " horizontalmovenum[curdepth] =  " << horizontalmovenum[curdepth] << " at curdepth " << curdepth <<"\n";//debug 
-				horizontalmovenum[curdepth] = horizontalmovenum[curdepth] + 1;//increment displacer for list of horizontal moves.
-				movenum[curdepth] = movenum[curdepth] + 5;//offset based on number of elements per pseudo row.             
-            }
-            else if ((piecetomove == 't' && (boardarray[YWIDTH*piecetomovey + curx] == 'X' || boardarray[YWIDTH*piecetomovey + curx] == 'T'))
-                || (piecetomove == 'T' && (boardarray[YWIDTH*piecetomovey + curx] == 'x' || boardarray[YWIDTH*piecetomovey + curx] == 't')))
-            {//if it is capturing a piece, do the same, but return, since checking after would be considered jumping
-                listoflegalmoves[LISTSIZE*curdepth + movenum[curdepth]] = piecetomovex;//add old and new locations to list of legal moves to play.
-                listoflegalmoves[LISTSIZE*curdepth + movenum[curdepth]+1] = piecetomovey;//offset by movenum[curdepth].
-                listoflegalmoves[LISTSIZE*curdepth + movenum[curdepth]+2] = curx;//make sure we use the current step to add
-                listoflegalmoves[LISTSIZE*curdepth + movenum[curdepth]+3] = piecenewy;
-                listoflegalmoves[LISTSIZE*curdepth + movenum[curdepth]+4] = piecenum;//the piece being moved.       
-                //cout << "Adding horizontal tie move " << char(listoflegalmoves[movenum[curdepth]+0] + 'A')<< " " << char(YWIDTH - listoflegalmoves[movenum[curdepth]+1] + '0')
-				//	<< " " << char(listoflegalmoves[movenum[curdepth]+2] + 'A') << " " << char(YWIDTH - listoflegalmoves[movenum[curdepth]+3] + '0') << "\n";
-
-				listofhorizontaltiemoves[24*curdepth + horizontalmovenum[curdepth]] = movenum[curdepth];//put the movenumber that was horizontal, we can check it later.
-				//cout << "		listofhorizontaltiemoves[24*curdepth + blah] = " << movenum[curdepth] << " horizontalmovenum[curdepth] =  " << horizontalmovenum[curdepth] << " at curdepth " << curdepth <<"\n";//debug 
-				horizontalmovenum[curdepth] = horizontalmovenum[curdepth] + 1;//increment displacer for list of horizontal moves.
-				movenum[curdepth] = movenum[curdepth] + 5;//offset based on number of elements per pseudo row.
-                return 0;
-            }
-			else
-            {//might as well return, since it is trying to jump over a piece.
-
-                  /*TODO cout << "Can't jump over a piece (x axis).  please enter a valid input.";
-                printf("\n");*/
-                return 1;
-            }
-        }
-        
-        //if we get here, we can assume that it reached to the destination:  Add this play as well.
-        
-    } 
-	else
-    {//vertical move(no x delta)
-        if (piecetomovey > piecenewy)
-        {//setup counter to go from old point to new point, making incrementer negative if necessary
-			//cout << "piecetomovey > piecenewy.  piecetomovey = " << piecetomovey << " piecenewy = " << piecenewy << "\n";				
-            ystep = -1;//trying to go to new piece, ex.  oldx = 6, newx = 4, go by -1
-        }
-        else
-        {
-			//cout << "piecetomovey < piecenewy.  piecetomovey = " << piecetomovey << " piecenewy = " << piecenewy << "\n";						
-            ystep = 1;
-        }
-        
-        int cury = piecetomovey + ystep;//initialize variable to be one off it's starting point, so it doesn't check itself.
-        /*we add by one so it doesn't check itself.  Also because if it moves by one step, 
-        //no need to check if it jumps, since it isn't jumping anything if it is just moving adjacently.*/
-        for ( ; cury != piecenewy; cury = cury + ystep)
-        {//increment the steps to the new position, only have to worry about the x axis
-			//I'm making it != so that it can work both for increment and decrement.
-            
-            /*cout << "Checking current y: " << cury;//DEBUG see xstep
-            printf("\n");*///debug
-                      if (boardarray[YWIDTH*cury + piecetomovex] == EMPTYCHAR || boardarray[YWIDTH*cury + piecetomovex] == MOVECHAR )
-            {//if the tie fighter isn't jumping over a piece, or is capturing an enemy piece.
-                if (ystep != backstep)
-                {//if this tie fighter isn't moving backwards, you can add it.
-                    listoflegalmoves[LISTSIZE*curdepth + movenum[curdepth]] = piecetomovex;//add old and new locations to list of legal moves to play.
-                    listoflegalmoves[LISTSIZE*curdepth + movenum[curdepth]+1] = piecetomovey;//offset by movenum[curdepth].
-                    listoflegalmoves[LISTSIZE*curdepth + movenum[curdepth]+2] = piecetomovex;//make sure we use the current step to add
-                    listoflegalmoves[LISTSIZE*curdepth + movenum[curdepth]+3] = cury;
-                    listoflegalmoves[LISTSIZE*curdepth + movenum[curdepth]+4] = piecenum;//the piece being moved.                
-                    //cout << "Adding horizontal tie move " << char(listoflegalmoves[movenum[curdepth]+0] + 'A')<< " " << char(YWIDTH - listoflegalmoves[movenum[curdepth]+1] + '0')
-                    //	<< " " << char(listoflegalmoves[movenum[curdepth]+2] + 'A') << " " << char(YWIDTH - listoflegalmoves[movenum[curdepth]+3] + '0') << "\n";
-                    movenum[curdepth] = movenum[curdepth] + 5;//offset based on number of elements per pseudo row.
-                }
-            }
-            else if ((piecetomove == 't' && (boardarray[YWIDTH*cury + piecetomovex] == 'X' || boardarray[YWIDTH*cury + piecetomovex] == 'T'))
-                || (piecetomove == 'T' && (boardarray[YWIDTH*cury + piecetomovex] == 'x' || boardarray[YWIDTH*cury + piecetomovex] == 't')))
-            {//if it is capturing a piece, do the same, but return, since checking after would be considered jumping
-                listoflegalmoves[LISTSIZE*curdepth + movenum[curdepth]] = piecetomovex;//add old and new locations to list of legal moves to play.
-                listoflegalmoves[LISTSIZE*curdepth + movenum[curdepth]+1] = piecetomovey;//offset by movenum[curdepth].
-                listoflegalmoves[LISTSIZE*curdepth + movenum[curdepth]+2] = piecetomovex;//make sure we use the current step to add
-                listoflegalmoves[LISTSIZE*curdepth + movenum[curdepth]+3] = cury;
-                listoflegalmoves[LISTSIZE*curdepth + movenum[curdepth]+4] = piecenum;//the piece being moved.              
-                //cout << "Adding horizontal tie move " << char(listoflegalmoves[movenum[curdepth]+0] + 'A')<< " " << char(YWIDTH - listoflegalmoves[movenum[curdepth]+1] + '0')
-				//	<< " " << char(listoflegalmoves[movenum[curdepth]+2] + 'A') << " " << char(YWIDTH - listoflegalmoves[movenum[curdepth]+3] + '0') << "\n";
- 				movenum[curdepth] = movenum[curdepth] + 5;//offset based on number of elements per pseudo row.
-               
-                return 0;
-            }
-			else if (piecetomove == 't' && boardarray[YWIDTH*cury + piecenewx] == '*' && (piecetomovex == 3 && piecetomovey == 0))
-            {//if the tie's trying to capture the death star not from behind (human)
-                listoflegalmoves[LISTSIZE*curdepth + movenum[curdepth]] = piecetomovex;//add old and new locations to list of legal moves to play.
-                listoflegalmoves[LISTSIZE*curdepth + movenum[curdepth]+1] = piecetomovey;//offset by movenum[curdepth].
-                listoflegalmoves[LISTSIZE*curdepth + movenum[curdepth]+2] = piecetomovex;//make sure we use the current step to add
-                listoflegalmoves[LISTSIZE*curdepth + movenum[curdepth]+3] = cury;
-                listoflegalmoves[LISTSIZE*curdepth + movenum[curdepth]+4] = piecenum;//the piece being moved.              
-                //cout << "Adding horizontal tie move " << char(listoflegalmoves[movenum[curdepth]+0] + 'A')<< " " << char(YWIDTH - listoflegalmoves[movenum[curdepth]+1] + '0')
-				//	<< " " << char(listoflegalmoves[movenum[curdepth]+2] + 'A') << " " << char(YWIDTH - listoflegalmoves[movenum[curdepth]+3] + '0') << "\n";
- 				movenum[curdepth] = movenum[curdepth] + 5;//offset based on number of elements per pseudo row.
-                return 0;
-            }
-            else if (piecetomove == 'T'  && boardarray[YWIDTH*cury + piecenewx] == '@' && (piecetomovex == 3 && piecetomovey == 6))
-            {//same as before, but computer.
-                listoflegalmoves[LISTSIZE*curdepth + movenum[curdepth]] = piecetomovex;//add old and new locations to list of legal moves to play.
-                listoflegalmoves[LISTSIZE*curdepth + movenum[curdepth]+1] = piecetomovey;//offset by movenum[curdepth].
-                listoflegalmoves[LISTSIZE*curdepth + movenum[curdepth]+2] = piecetomovex;//make sure we use the current step to add
-                listoflegalmoves[LISTSIZE*curdepth + movenum[curdepth]+3] = cury;
-                listoflegalmoves[LISTSIZE*curdepth + movenum[curdepth]+4] = piecenum;//the piece being moved.              
-                //cout << "Adding horizontal tie move " << char(listoflegalmoves[movenum[curdepth]+0] + 'A')<< " " << char(YWIDTH - listoflegalmoves[movenum[curdepth]+1] + '0')
-				//	<< " " << char(listoflegalmoves[movenum[curdepth]+2] + 'A') << " " << char(YWIDTH - listoflegalmoves[movenum[curdepth]+3] + '0') << "\n";
- 				movenum[curdepth] = movenum[curdepth] + 5;//offset based on number of elements per pseudo row.
-                return 1;
-            }
-            else
-            {//might as well return, since it is trying to jump over a piece.
-
-                  /*TODO cout << "Can't jump over a piece (x axis).  please enter a valid input.";
-                printf("\n");*/
-                return 1;
-            }
-        }
-		
-		
-		
-		
-    }
-    
-    
-    if (piecetomove == 't' && (boardarray[YWIDTH*piecenewy + piecenewx] == 'x' || boardarray[YWIDTH*piecenewy + piecenewx] == 't' ||
-	boardarray[YWIDTH*piecenewy + piecenewx] == '@'))
-	{//if the human's new location would capture it's own piece.
-		/*cout << "Invalid Tie Fighter Move:  Can't capture one's piece.  Please enter a valid move.";
-		printf("\n");*/
-		return 1;
+	int piecesquare = pos->piecepositions[piecenum*2]*YWIDTH + pos->piecepositions[piecenum*2+1];
+	int side = piecenum/(NUMOFPIECES*2);
+	bitboard occupied = pos->pieceboards[0] | pos->pieceboards[1] | pos->pieceboards[2] | pos->pieceboards[3];
+	bitboard empty = FULLBOARD & ~(occupied | WALLBOARD | COMPUTERDEATHSTAR | HUMANDEATHSTAR);
+	bitboard enemies = pos->pieceboards[2 - side*2] | pos->pieceboards[3 - side*2];
+	bitboard sidewaystargets = empty | enemies;
+	if (capturesonly == 1)
+	{
+		sidewaystargets = enemies;
 	}
-    else if (piecetomove == 'T' && (boardarray[YWIDTH*piecenewy + piecenewx] == 'X' || boardarray[YWIDTH*piecenewy + piecenewx] == 'T' ||
-		boardarray[YWIDTH*piecenewy + piecenewx] == '*'))
-	{//if the computer's new location would capture it's own piece.
-		/*cout << "I (the computer) made an Invalid Tie Fighter Move:  Can't capture one's piece.  Please enter a valid move.";
-		printf("\n");*/
-		return 1;
+	
+	if ((side == 0 ? pos->horizontalhuman : pos->horizontalcomputer) < 2)
+	{//if the tie fighter didn't move horizontally last turn.  Sideways moves don't care about forwards and backwards, but are flagged as horizontal moves.
+		addTargets(ctx, piecesquare, slideAttacks(piecesquare, LEFT, empty) & sidewaystargets, enemies, LEFT, curdepth, piecenum, MOVEHORIZONTAL);
+		addTargets(ctx, piecesquare, slideAttacks(piecesquare, RIGHT, empty) & sidewaystargets, enemies, RIGHT, curdepth, piecenum, MOVEHORIZONTAL);
 	}
- 
-    //Make sure the piece doesn't go backwards, unless it can capture
-    if (ystep == backstep && piecetomove == 't' && piecenewy > piecetomovey && 
-		boardarray[YWIDTH*piecenewy + piecenewx] != 'X' && boardarray[YWIDTH*piecenewy + piecenewx] != 'T' && 
-		boardarray[YWIDTH*piecenewy + piecenewx] != '*')
-    {//if this is a player's TIE fighter, remember that board is flipped for y axis.
-
-        /*cout << "Invalid Tie Fighter Move:  Can't go backwards without capturing enemy piece.  Please enter a valid move.";
-		printf("\n");*/          
-        return 1;
-
-
-    } 
-    else if (ystep == backstep && piecetomove == 'T' && piecenewy < piecetomovey && 
-			boardarray[YWIDTH*piecenewy + piecenewx] != 'x' && boardarray[YWIDTH*piecenewy + piecenewx] != 't' && 
-			boardarray[YWIDTH*piecenewy + piecenewx] != '@')
-    {//if this is a computer's TIE fighter trying to go backwards to a place without an enemy piece.
-
-        /*cout << "I (The computer) made an Invalid Tie Fighter Move:  Can't go backwards without capturing enemy piece.";
-		printf("\n");*/
-        return 1;
-    }
-    
-    
-    
-	//if it gets here, we can assume to add this move to the list, since it passed the other preconditions.
-
-	listoflegalmoves[LISTSIZE*curdepth + movenum[curdepth]] = piecetomovex;//add old and new locations to list of legal moves to play.
-	listoflegalmoves[LISTSIZE*curdepth + movenum[curdepth]+1] = piecetomovey;//offset by movenum[curdepth].
-	listoflegalmoves[LISTSIZE*curdepth + movenum[curdepth]+2] = piecenewx;//make sure we use the current step to add
-	listoflegalmoves[LISTSIZE*curdepth + movenum[curdepth]+3] = piecenewy;
-	listoflegalmoves[LISTSIZE*curdepth + movenum[curdepth]+4] = piecenum;//the piece being moved.
-	if (horizontalmove == 1)
-	{//if this was a horizontal move, add it to list of horizontal tie moves.
-		listofhorizontaltiemoves[24*curdepth + horizontalmovenum[curdepth]] = movenum[curdepth];//put the movenumber that was horizontal, we can check it later.
-		//cout << "Adding horizontal tie move " << char(listoflegalmoves[movenum[curdepth]+0] + 'A')<< " " << char(YWIDTH - listoflegalmoves[movenum[curdepth]+1] + '0')
-        //    << " " << char(listoflegalmoves[movenum[curdepth]+2] + 'A') << " " << char(YWIDTH - listoflegalmoves[movenum[curdepth]+3] + '0') << " "
-        //    << "for piecenum = " << piecenum << "\n";
-		horizontalmovenum[curdepth] = horizontalmovenum[curdepth] + 1;//increment displacer for list of horizontal moves.
-	}
-
-    movenum[curdepth] = movenum[curdepth] + 5;//offset based on number of elements per pseudo row.
-    //cout << "movenum after legal at depth " << curdepth << " is now " << movenum[curdepth] << "\n";  
-    //Increment after showing the move, so we don't increment and see a bunch of '0's
-    return 0;//assume they made a right move.
-    
-}
-
-int validateInput( int piecetomovex, int piecetomovey, int piecenewx, int piecenewy, char piecetomove, int curdepth, int piecenum)
-{//general method to validate input.
-    //1 = person messed up.
-    
-
-	//debug
-	//cout << "Piece isn't toppling itself " << char(piecetomovex + 'A') << " " << char(piecenewx + 'A') << " " << char( YWIDTH - piecetomovey + '0') << " " << char(YWIDTH - piecenewy + '0') << "\n";
-
-    if (((piecetomovex - piecenewx) == 0 && (piecetomovey - piecenewy) == 0) 
-        || (boardarray[YWIDTH*piecenewy + piecenewx] == '+' || boardarray[YWIDTH*piecenewy + piecenewx] == '~'))
-	{//if the piece was trying to capture a wall
-		/*cout << "You cannot capture a wall piece.  Please re enter input.";
-		printf("\n");*/
-		return 1;
+	//vertical moves.  Going backwards has to capture.
+	bitboard targets = (empty & movetables.forward[side][piecesquare]) | enemies | movetables.deathstarhits[piecenum/NUMOFPIECES][piecesquare];
+	if (capturesonly == 1)
+	{
+		targets &= ~empty;
 	}
-	else if (piecetomove == 'x' || piecetomove == 'X')
-    {//x wing, 
-        return legalXWing(piecetomovex, piecetomovey, piecenewx, piecenewy, piecetomove, curdepth, piecenum);
-    } 
-	else if (piecetomove == 't' || piecetomove == 'T')
-    {//tie fighter,
-        return legalTieFighter(piecetomovex, piecetomovey, piecenewx, piecenewy, piecetomove, curdepth, piecenum);
-    } 
-	else
-    {//if it isn't the player's stuff, it's something else.  And they can't mess with it
-        /*cout << piecetomove << " is not your piece to move.  Please re enter input" << piecetomovex << " " << piecetomovey;
-        printf("\n");*/
-        return 1;
-    }
-    
+	addTargets(ctx, piecesquare, slideAttacks(piecesquare, UP, empty) & targets, enemies, UP, curdepth, piecenum, 0);
+	addTargets(ctx, piecesquare, slideAttacks(piecesquare, DOWN, empty) & targets, enemies, DOWN, curdepth, piecenum, 0);
 }
 
-int checkGameOver()
+int checkGameOver(Position* pos)
 {//See if the game is over:  IF the death star is taken or no more legal moves
-    if (boardarray[10] != '*')
-    {//if either of the player's death stars are no longer death stars (can do this since the previous method validates that something
+	bitboard occupied = pos->pieceboards[0] | pos->pieceboards[1] | pos->pieceboards[2] | pos->pieceboards[3];
+    if ((occupied & COMPUTERDEATHSTAR) != 0)
+    {//if either of the player's death stars are no longer death stars (can do this since the move generator validates that something
         //can be on this space
         //cout << "Game Over:  My Death Star is destroyed.  You win.";
         //printf("\n");
 		return 1;
-    } else if (boardarray[38] != '@')
+    } else if ((occupied & HUMANDEATHSTAR) != 0)
 	{
 		//cout << "Game Over:  Your Death Star is destroyed.  I win.";
 		//printf("\n");
@@ -1103,9 +1536,9 @@ int checkGameOver()
 
 }
 
-int checkNoMoves(int whichplayer, int curdepth)
+int checkNoMoves(SearchContext* ctx, int whichplayer, int curdepth)
 {//see if there are no valid moves the player can make:  if so, end game
-	if (movenum[curdepth] == 0)
+	if (ctx->movenum[curdepth] == 0)
     {//If the player cannot currently move any pieces.  Check list of legal moves, if there's nothing there, then game over, pal.
         cout << "Game Over:  No more pieces to move.";
         if (whichplayer == 0)
@@ -1124,193 +1557,70 @@ int checkNoMoves(int whichplayer, int curdepth)
 	return 0;
 }
 
-void findHumanMoves(int curdepth)
+void findHumanMoves(Position* pos, SearchContext* ctx, int curdepth)
 {//finds the list of moves a human can make
-	int piecenum = 0;//the piece that is being moved.
-    for (;piecenum < NUMOFPIECES*2;piecenum++)
-    {//get location:  increment by 2, since we're treating this similar to a 2d array, first part y pos, second part x pos
-       
-        
-        //here, we only need to check four cases:  The absolute limits of the x wing's position to move.
-        //We let the validation add the list of moves.
-		
-		
-        
-        
-        //cout << "Current piecenum and capturedpieces " << piecenum << " " << capturedpieces[piecenum] <<  "\n";
-		
-        if (capturedpieces[piecenum] == 0 )
-		{//if the piece still exists, I can tell since I force pieces out of the board.
-            int piecetomovey = piecepositions[piecenum*2];
-            int piecetomovex = piecepositions[piecenum*2+1];//offset, for x position.
-            char piecetomove = boardarray[YWIDTH*piecetomovey + piecetomovex];
-			//cout << "current stuff in findHumanMoves:  " << char(piecetomovex + 'A') << char(YWIDTH - piecetomovey + '0') << " " << piecetomove << "\n";
-			
-            
-            
-			if (piecenum < 4  && piecetomove == 'x')
-            {//if this is a human x wing
-                //cout << "x wing piecenum = " << piecenum << "\n";
-
-                //top left and bottom right corner cases
-                if (piecetomovex <= piecetomovey)
-                {//if x will hit 0 before y in the top left corner.
-                    //top left, x is always 0
-                    validateInput(piecetomovex, piecetomovey, 0, piecetomovey - piecetomovex, piecetomove, curdepth, piecenum);
-                    //bottom right, y is always YWIDTH - 1
-                    validateInput(piecetomovex, piecetomovey, piecetomovex + ((YWIDTH - 1) - piecetomovey), YWIDTH - 1, piecetomove, curdepth, piecenum);
-                    
-                }
-                else
-                {//if y would hit 0 before x in the top left corner.
-                    //top left, y is always 0
-                    validateInput(piecetomovex, piecetomovey, piecetomovex - piecetomovey, 0 , piecetomove, curdepth, piecenum);
-                    //bottom right, x is always XWIDTH - 1
-                    validateInput(piecetomovex, piecetomovey, XWIDTH - 1, piecetomovey + ((XWIDTH - 1) - piecetomovex) , piecetomove, curdepth, piecenum);
-                }
-                //top right and bottom left corner cases
-                if (piecetomovex <= ((YWIDTH - 1) - piecetomovey))
-                {//if y would hit the 0 before x reaches XWIDTH.
-                    //top right, y is always 0
-                    validateInput(piecetomovex, piecetomovey, piecetomovex + piecetomovey, 0, piecetomove, curdepth, piecenum); 
-                    //bottom left, x is always 0
-                    validateInput(piecetomovex, piecetomovey, 0, piecetomovey + piecetomovex, piecetomove, curdepth, piecenum);                    
-                }
-                else
-                {//if x will hit the XWIDTH before y hits 0.
-                    //top right, x is always XWIDTH - 1
-                    validateInput(piecetomovex, piecetomovey, XWIDTH - 1, piecetomovey - ((XWIDTH - 1) - piecetomovex), piecetomove, curdepth, piecenum);    
-                    //bottom left, y is always YWIDTH - 1
-                    validateInput(piecetomovex, piecetomovey, piecetomovex - ((YWIDTH - 1) - piecetomovey), YWIDTH - 1, piecetomove, curdepth, piecenum);    
-                    
-                }
-                
-                
-                //deprecated: Not going to brute force search for possible moves.
-                /*for (int xstep = 0; xstep < XWIDTH; xstep++)
-                {//look at all x points
-                    for (int ystep = 0; ystep < YWIDTH; ystep++)
-                    {//look at all y points.
-                        //cout << "Checking newx " << xstep << " newy " << ystep << "\n";//debug
-                        validateInput(piecetomovex, piecetomovey, xstep, ystep, piecetomove, curdepth, piecenum);
-                    }
-                }*/
-            }			
-			
-			if (piecenum>= 4 && piecetomove == 't')
-			{//if this is a tie fighter, do the optimized validate input based on the fact that it can move vertical or horizontal only, so go to the board limits and find out the values.
-				//basically, check the edges of the map that the rook can move to (max and min horizontal no y change, and vice versa.)
-				validateInput(piecetomovex, piecetomovey, 0, piecetomovey, piecetomove, curdepth, piecenum );
-				validateInput(piecetomovex, piecetomovey, XWIDTH-1, piecetomovey, piecetomove, curdepth, piecenum  );
-				validateInput(piecetomovex, piecetomovey, piecetomovex, 0, piecetomove, curdepth, piecenum );
-				validateInput(piecetomovex, piecetomovey, piecetomovex, YWIDTH-1, piecetomove, curdepth, piecenum );				
+	for (int piecenum = 0; piecenum < NUMOFPIECES*2; piecenum++)
+	{//first four are x wings, the next four are tie fighters.
+		if (pos->capturedpieces[piecenum] == 0)
+		{//if the piece still exists.
+			if (piecenum < NUMOFPIECES)
+			{
+				legalXWing(pos, ctx, piecenum, curdepth, 0);
 			}
-			
-
-        }
-		
-    }
-	
-    
-
- 
+			else
+			{
+				legalTieFighter(pos, ctx, piecenum, curdepth, 0);
+			}
+		}
+	}
 }
 
-void findComputerMoves(int curdepth)
+void findComputerMoves(Position* pos, SearchContext* ctx, int curdepth)
 {//finds the list of moves a computer can make
-	int piecenum = 8;//here, we start after the halfway point, which happens to be NUMOFPIECES*8/4
-	
-	
-	
-	
-    for (;piecenum < NUMOFPIECES*4;piecenum++)
-    {//get location:  increment by 2, since we're treating this similar to a 2d array, first part y pos, second part x pos
-		//cout << "Current piecenum and capturedpieces " << piecenum << " " << capturedpieces[piecenum] << " and " << capturedpieces[piecenum] << "\n";
-
-
-		if (capturedpieces[piecenum] == 0 )
-		{//if the piece still exists, I can tell since I force pieces out of the board.
-			//make sure to check that the piece isn't captured and the piece is proper.
-			//Here, we do the sloppy way, check every element.
-
-            int piecetomovey = piecepositions[piecenum*2];
-            int piecetomovex = piecepositions[piecenum*2+1];//offset, for x position.
-            char piecetomove = boardarray[YWIDTH*piecetomovey + piecetomovex];
-            
-			if (piecenum < 12 && piecetomove == 'X')
-            {
-              //top left and bottom right corner cases
-                if (piecetomovex <= piecetomovey)
-                {//if x will hit 0 before y in the top left corner.
-                    //top left, x is always 0
-                    validateInput(piecetomovex, piecetomovey, 0, piecetomovey - piecetomovex, piecetomove, curdepth, piecenum);
-                    //bottom right, y is always YWIDTH - 1
-                    validateInput(piecetomovex, piecetomovey, piecetomovex + ((YWIDTH - 1) - piecetomovey), YWIDTH - 1, piecetomove, curdepth, piecenum);
-                    
-                }
-                else
-                {//if y would hit 0 before x in the top left corner.
-                    //top left, y is always 0
-                    validateInput(piecetomovex, piecetomovey, piecetomovex - piecetomovey, 0 , piecetomove, curdepth, piecenum);
-                    //bottom right, x is always XWIDTH - 1
-                    validateInput(piecetomovex, piecetomovey, XWIDTH - 1, piecetomovey + ((XWIDTH - 1) - piecetomovex) , piecetomove, curdepth, piecenum);
-                }
-                //top right and bottom left corner cases
-                if (piecetomovex <= ((YWIDTH - 1) - piecetomovey))
-                {//if y would hit the 0 before x reaches XWIDTH.
-                    //top right, y is always 0
-                    validateInput(piecetomovex, piecetomovey, piecetomovex + piecetomovey, 0, piecetomove, curdepth, piecenum); 
-                    //bottom left, x is always 0
-                    validateInput(piecetomovex, piecetomovey, 0, piecetomovey + piecetomovex, piecetomove, curdepth, piecenum);                    
-                }
-                else
-                {//if x will hit the XWIDTH before y hits 0.
-                    //top right, x is always XWIDTH - 1
-                    validateInput(piecetomovex, piecetomovey, XWIDTH - 1, piecetomovey - ((XWIDTH - 1) - piecetomovex), piecetomove, curdepth, piecenum);    
-                    //bottom left, y is always YWIDTH - 1
-                    validateInput(piecetomovex, piecetomovey, piecetomovex - ((YWIDTH - 1) - piecetomovey), YWIDTH - 1, piecetomove, curdepth, piecenum);    
-                    
-                }
-                   
-                
-            }
-			
-			
-			if (piecenum >= 12 && piecetomove == 'T')
-			{//if this is a tie fighter, do the optimized validate input based on the fact that it can move vertical or horizontal only, so go to the board limits and find out the values.
-				validateInput(piecetomovex, piecetomovey, 0, piecetomovey, piecetomove, curdepth, piecenum );
-				validateInput(piecetomovex, piecetomovey, XWIDTH-1, piecetomovey, piecetomove, curdepth, piecenum  );
-				validateInput(piecetomovex, piecetomovey, piecetomovex, 0, piecetomove, curdepth, piecenum );
-				validateInput(piecetomovex, piecetomovey, piecetomovex, YWIDTH-1, piecetomove, curdepth, piecenum );				
+	for (int piecenum = NUMOFPIECES*2; piecenum < NUMOFPIECES*4; piecenum++)
+	{//here, we start after the halfway point.
+		if (pos->capturedpieces[piecenum] == 0)
+		{//if the piece still exists.
+			if (piecenum < NUMOFPIECES*3)
+			{
+				legalXWing(pos, ctx, piecenum, curdepth, 0);
 			}
-						
-			//cout << "current stuff in findComputerMoves:  " << char(piecetomovex + 'A') << char(YWIDTH - piecetomovey + '0') << " " << piecetomove << "\n";          
-        }
-    }
-	
-
+			else
+			{
+				legalTieFighter(pos, ctx, piecenum, curdepth, 0);
+			}
+		}
+	}
 }
 
+void findCaptures(Position* pos, SearchContext* ctx, int whichplayer, int curdepth)
+{//finds only the captures and death star hits a player can make, for the quiescence search.  0 = human, 1 = computer.
+	for (int piecenum = whichplayer*NUMOFPIECES*2; piecenum < (whichplayer + 1)*NUMOFPIECES*2; piecenum++)
+	{
+		if (pos->capturedpieces[piecenum] == 0)
+		{
+			if (piecenum % (NUMOFPIECES*2) < NUMOFPIECES)
+			{
+				legalXWing(pos, ctx, piecenum, curdepth, 1);
+			}
+			else
+			{
+				legalTieFighter(pos, ctx, piecenum, curdepth, 1);
+			}
+		}
+	}
+}
 
-int checkListOfMoves()
+int checkListOfMoves(SearchContext* ctx, int from, int to)
 {//check the list of moves with this, see if any of them are equal to the user's input.  Only to be used with human input.
-	//cout << "Checking list of legal moves " << (movenum[curdepth]/4) << "\n";//divide by offset, oldx oldy newx newy(4)
+	//cout << "Checking list of legal moves " << movenum[curdepth] << "\n";
     //cout << "List of Legal Moves:  ";
-    for (int counter = 0; counter < movenum[0]; counter = counter + 5)
-    {//increment through each move, showing them.  Each move is four elements, so increment by that many elements.
-        //char xold = listoflegalmoves[counter] + 'A';//just like with int to char, need to displace by ASCII text
-        //char yold = (YWIDTH - listoflegalmoves[counter+1]) + '0';// to get inverse, a = width - b
-        //char xnew = listoflegalmoves[counter+2] + 'A';
-        //char ynew = (YWIDTH - listoflegalmoves[counter+3]) + '0';
-    
-        //cout << " " << xold << "" << yold << "" << xnew << "" << ynew;
-		
-		if (movestack[0] == listoflegalmoves[counter] && movestack[1] == listoflegalmoves[counter+1] 
-			&& movestack[2] == listoflegalmoves[counter+2] && movestack[3] == listoflegalmoves[counter+3])
+    for (int counter = 0; counter < ctx->movenum[0]; counter++)
+    {//increment through each move.
+		if (moveFrom(ctx->listoflegalmoves[counter]) == from && moveTo(ctx->listoflegalmoves[counter]) == to)
 		{//if the move the person entered matches one of the valid moves.
-			humanmovenum = counter;//to see if a horizontal move was made in main method.
-			//cout << "Humanmovenum at checklistofmoves = " << humanmovenum << "\n";			
-			return listoflegalmoves[counter+4];//success, return the piecenum to be used in movepiece at the main method. 
+			ctx->movestack[0] = ctx->listoflegalmoves[counter];//put it on the stack, for movePiece in the main method.
+			return movedPiece(ctx->listoflegalmoves[counter]);//success, return the piecenum, so main knows the move was good.
 		}
 		
     }
@@ -1318,73 +1628,57 @@ int checkListOfMoves()
 	return -1;
 }
 
-int checkListOfHorizontalMoves(int movenumber, int curdepth)
-{//check to see if the move was horizontal, to be used in minimax algorithm.
-	//cout << "              horizontalmovenum[curdepth] = " << horizontalmovenum[curdepth] << " and curdepth = " << curdepth << "\n";
-	for (int counter = curdepth*24; counter < horizontalmovenum[curdepth]; counter++)
-	{//iterate through list of horizontal moves 
-		//cout << "Movenumber is " << movenumber << " and listofhorizontalmoves at counter is " 
-		//	<< listofhorizontaltiemoves[counter] << " with counter as " << counter << " \n";//debug
-		if (movenumber == listofhorizontaltiemoves[counter])
-		{//if the move was indeed a horizontal one
-			//cout << "This move is horizontal at curdepth " << curdepth << "\n";
-			return 1;
-		}
-	}
-	return 0;
-}
-
-
-void showListOfMoves(int curdepth)
+void showListOfMoves(Position* pos, SearchContext* ctx, int curdepth)
 {//show the list of legal moves to immediately make;
-    cout << "Number of legal moves at listindex "<< curdepth*LISTSIZE << " is " << (movenum[curdepth]/5) << "\n";//divide by offset, oldx oldy newx newy(4)
+    cout << "Number of legal moves at listindex "<< curdepth*LISTSIZE << " is " << ctx->movenum[curdepth] << "\n";
     cout << "List of Legal Moves:  ";
 	int counter = 0;
-    for (; counter < movenum[curdepth]; counter = counter + 5)
-    {//increment through each move, showing them.  Each move is four elements, so increment by that many elements.
-        char xold = listoflegalmoves[LISTSIZE*curdepth + counter] + 'A';//just like with int to char, need to displace by ASCII text
-        char yold = (YWIDTH - listoflegalmoves[LISTSIZE*curdepth + counter+1]) + '0';// to get inverse, a = width - b
-        char xnew = listoflegalmoves[LISTSIZE*curdepth + counter+2] + 'A';
-        char ynew = (YWIDTH - listoflegalmoves[LISTSIZE*curdepth + counter+3]) + '0';
-		//int piecemoved = listoflegalmoves[LISTSIZE*curdepth + counter + 4];//debug for which piece moved.
+    for (; counter < ctx->movenum[curdepth]; counter++)
+    {//increment through each move, showing them.
+		Move move = ctx->listoflegalmoves[LISTSIZE*curdepth + counter];
+        char xold = moveFrom(move) % XWIDTH + 'A';//just like with int to char, need to displace by ASCII text
+        char yold = (YWIDTH - moveFrom(move) / XWIDTH) + '0';// to get inverse, a = width - b
+        char xnew = moveTo(move) % XWIDTH + 'A';
+        char ynew = (YWIDTH - moveTo(move) / XWIDTH) + '0';
+		//int piecemoved = movedPiece(move);//debug for which piece moved.
         cout << " " << xold  << yold  << xnew  << ynew ;//<< " piecenum: " << piecemoved;//debug after comment , before << that's before piecenum
 		
-		showNewMovesOnBoard(listoflegalmoves[curdepth + counter+2], listoflegalmoves[curdepth + counter+3]);
+		showNewMovesOnBoard(pos, moveTo(move) % XWIDTH, moveTo(move) / XWIDTH);
     }
     printf("\n");
 }
 
-void showAllMoves()
+void showAllMoves(Position* pos, SearchContext* ctx)
 {//Debug, to show all moves on the array, for each depth.
     for (int counter = 0; counter < MAXDEPTH; counter++)
     {//look at each movenum, and see list of moves per thingy.
-        if (movenum[counter] == 0)
+        if (ctx->movenum[counter] == 0)
         {//if that depth had no moves, end.  No need to show.
             break;
         }
-        showListOfMoves(counter);
+        showListOfMoves(pos, ctx, counter);
         //cleanBoard();
     }
 }
 
 
-void showNewMovesOnBoard(int newx, int newy)
+void showNewMovesOnBoard(Position* pos, int newx, int newy)
 {//show graphically the possible moves
-	if (boardarray[newy*YWIDTH + newx] == EMPTYCHAR)
+	if (pos->boardarray[newy*YWIDTH + newx] == EMPTYCHAR)
 	{//if this is a blank spot, then we can replace:  Don't replace any pieces.
-		boardarray[newy*YWIDTH + newx] = MOVECHAR;//show on board the movement possibilities
+		pos->boardarray[newy*YWIDTH + newx] = MOVECHAR;//show on board the movement possibilities
 	}
 }
 
-void cleanBoard()
+void cleanBoard(Position* pos)
 {//clean the board of possible moves
 	for (int xloc = 0; xloc < XWIDTH; xloc++)
 	{//Do the lazy look at the whole board thing.
 		for (int yloc = 0; yloc < YWIDTH; yloc++)
 		{
-			if (boardarray[yloc*YWIDTH + xloc] == MOVECHAR)
+			if (pos->boardarray[yloc*YWIDTH + xloc] == MOVECHAR)
 			{//if this was considered a possible move, reset it.  Might not be possible next turn.
-				boardarray[yloc*YWIDTH + xloc] = EMPTYCHAR;
+				pos->boardarray[yloc*YWIDTH + xloc] = EMPTYCHAR;
 			}
 		}
 	}
@@ -1418,480 +1712,2819 @@ void cleanBoard()
     cout << "Stack:  \n";
     for (int counter = 0; counter < curdepth+1; counter++)
     {   
-        cout << char(movestack[counter*6] + 'A') << char(YWIDTH - movestack[counter*6 + 1] + '0') << char(movestack[counter*6 + 2] + 'A') 
-			<< char(YWIDTH - movestack[counter*6 + 3] + '0') << " " << char(movestack[counter*6 + 4]) << " " << char(movestack[counter*6 + 5]) << "\n";
+        cout << char(moveFrom(movestack[counter]) % XWIDTH + 'A') << char(YWIDTH - moveFrom(movestack[counter]) / XWIDTH + '0') << char(moveTo(movestack[counter]) % XWIDTH + 'A') 
+			<< char(YWIDTH - moveTo(movestack[counter]) / XWIDTH + '0') << " " << movedPiece(movestack[counter]) << " " << undostack[counter].captured << "\n";
         showListOfMoves(counter);
     }
 }*/
 
-int maxMove(int curdepth, int beta)
-{//computer (best) move
-    //cout << "MaxalgoDepth " << curdepth << "\n";
-	int temphorizontal = horizontalcomputer;//placeholder, to make sure it doesn't mess up too much.	
-	int best = BELOWWORST;
-    movenum[curdepth] = 0;//haven't found a list of moves yet.   
-	horizontalmovenum[curdepth] = 0;//haven't had a list of horizontal tie moves yet, either
-	horizontalhuman = temphorizontal;//replace the piece, since the above messes with it.	
-	horizontalcomputer = horizontalcomputer - 1;
-	if (curdepth == MAXDEPTH)
-	{//if we reached the end of the depth we can search, evaluate this move's heuristic value
-        //cout << "evaluate\n";
-		horizontalcomputer = temphorizontal;
-		return evaluate( curdepth );
+bitboard positionKey(Position* pos, int computertomove)
+{//the key for the whole position:  pieces, side to move, and which sides can't move a tie fighter sideways.  A horizontal tie value of 1
+	//allows the same moves as 0, so they get the same key, like in tablebaseIndex.
+	bitboard key = pos->zobristkey ^ zobrist.horizontal[0][pos->horizontalhuman == 2] ^ zobrist.horizontal[1][pos->horizontalcomputer == 2];
+	if (computertomove == 1)
+	{
+		key ^= zobrist.computertomove;
 	}
-    if (checkGameOver() == 1)
-    {//if it was game over here, then the human won.
-		horizontalcomputer = temphorizontal;	
-        return BELOWWORST + 1 + curdepth;//use curdepth to indicate how much more winning it is:  earlier win(lower curdepth) = better
-    }
-	findComputerMoves(curdepth);
-	//showListOfMoves(curdepth);//debug
-	
-    if (movenum[curdepth] == 0)
-    {
-		horizontalcomputer = temphorizontal;	
-        return BELOWWORST + 1 + curdepth;
-    }
-    
-    
-    
+	return key;
+}
 
-	for (int movecounter = LISTSIZE*curdepth; movecounter < LISTSIZE*curdepth + movenum[curdepth]; movecounter = movecounter + 5)
-	{//go through each move, and pretend to move the piece.
-		//char xold = listoflegalmoves[movecounter] + 'A';//just like with int to char, need to displace by ASCII text
-        //char yold = (YWIDTH - listoflegalmoves[movecounter+1]) + '0';// to get inverse, a = width - b
-        //char xnew = listoflegalmoves[movecounter+2] + 'A';
-        //char ynew = (YWIDTH - listoflegalmoves[movecounter+3]) + '0';
-        //cout << " " << xold << "" << yold << "" << xnew << "" << ynew;//Debug, to see moves made
-		
-		//put the move on the stack
-		movestack[movestackoff] = listoflegalmoves[movecounter];
-		movestack[movestackoff + 1] = listoflegalmoves[movecounter+1];
-		movestack[movestackoff+2] = listoflegalmoves[movecounter+2];
-		movestack[movestackoff+3] = listoflegalmoves[movecounter+3];
-		movestack[movestackoff+4] = boardarray[yoffoldy + movestack[movestackoff]];
-        movestack[movestackoff + 5] = boardarray[yoffnewy + movestack[movestackoff+2]];        
-		//char charx =  movestack[movestackoff] + 'A';//debug
-		//char chary =  YWIDTH - movestack[movestackoff + 1] + '0';
-		//cout << "piecetomove = " << piecetomove << " at " << charx << chary << " in depth " << curdepth << "\n";//debug
-		//cout << "Movenumber to go into method is " << movecounter % (LISTSIZE*curdepth) << "\n";//debug
-		if (movestack[movestackoff + 4] == 'T' && horizontalcomputer != 1 && checkListOfHorizontalMoves(movecounter % (LISTSIZE*curdepth),curdepth) == 1)
-		{//if this was a horizontal move, pretend it was one by setting the horizontal value.
-			horizontalcomputer = 2;
+bitboard packTransposition(int score, int remainingdepth, int bound, int bestfrom, int bestto)
+{//bits 0-9 score (offset by 512), 10-17 depth, 18-19 bound, 20-25 best move from square, 26-31 best move to square, 32-39 generation
+	return (bitboard)(score + 512) | ((bitboard)remainingdepth << 10) | ((bitboard)bound << 18)
+		| ((bitboard)bestfrom << 20) | ((bitboard)bestto << 26) | ((bitboard)(ttgeneration & 255) << 32);
+}
+
+int probeTransposition(bitboard key, int curdepth, int* remainingdepth, int* score, int* bound, int* bestfrom, int* bestto)
+{//look for the position in its bucket.  Returns 1 if it was there, even if it wasn't searched deep enough, since the best move is still useful.
+	TTBucket* bucket = &transpositiontable[key & (TTNUMOFBUCKETS - 1)];
+	for (int entrynum = 0; entrynum < TTBUCKETSIZE; entrynum++)
+	{
+		bitboard data = bucket->entries[entrynum].data.load(memory_order_relaxed);
+		if ((bucket->entries[entrynum].key.load(memory_order_relaxed) ^ data) == key)
+		{
+			*score = (int)(data & 1023) - 512;
+			*remainingdepth = (int)((data >> 10) & 255);
+			*bound = (int)((data >> 18) & 3);
+			*bestfrom = (int)((data >> 20) & 63);
+			*bestto = (int)((data >> 26) & 63);
+			//game over scores were stored as distance from the position, make them distance from the root again.
+			if (*score > WINNINGSCORE)
+			{
+				*score -= curdepth;
+			}
+			else if (*score < -WINNINGSCORE)
+			{
+				*score += curdepth;
+			}
+			return 1;
 		}
-		
-		
-		movePiece(curdepth, listoflegalmoves[movecounter+4]);//pretend to move the piece
-		int score = minMove(curdepth + 1, best);//go to max move, and increment depth by one.
-		
-		if (score > best)
-		{//if the score is better than the best move
-            //cout << "Found a better move. at " << curdepth << " with value of " << score << " \n";
-			best = score;//change best to current score.
-            
+	}
+	return 0;
+}
+
+void storeTransposition(bitboard key, int curdepth, int remainingdepth, int score, int bound, int bestfrom, int bestto)
+{//remember the search result.  Replaces the same position if it is there, otherwise the oldest, shallowest entry in the bucket.
+	TTBucket* bucket = &transpositiontable[key & (TTNUMOFBUCKETS - 1)];
+	TTEntry* replace = &bucket->entries[0];
+	int replacevalue = 1 << 30;
+	for (int entrynum = 0; entrynum < TTBUCKETSIZE; entrynum++)
+	{
+		TTEntry* entry = &bucket->entries[entrynum];
+		bitboard data = entry->data.load(memory_order_relaxed);
+		if ((entry->key.load(memory_order_relaxed) ^ data) == key)
+		{//same position, just update it.
+			replace = entry;
+			if (bestfrom == NOSQUARE)
+			{//keep the old best move if there isn't a new one.
+				bestfrom = (int)((data >> 20) & 63);
+				bestto = (int)((data >> 26) & 63);
+			}
+			break;
 		}
-        //printBoard();//debug
-		resetPiecePosition(1, curdepth, listoflegalmoves[movecounter+4]);
-		//reset the horizontal value.
-		if (movestack[movestackoff + 4] == 'T' && checkListOfHorizontalMoves(movecounter,curdepth) == 1)
-		{//if this was a horizontal move, stop pretending it was one by resetting the horizontal value.
-			cout << "resetting horizontal tie computer\n";
-			horizontalcomputer = temphorizontal;
+		int value = (int)((data >> 10) & 255);//depth
+		if ((int)((data >> 32) & 255) != (ttgeneration & 255))
+		{//from an earlier move:  Replace these first.
+			value -= 256;
+		}
+		if (value < replacevalue)
+		{
+			replacevalue = value;
+			replace = entry;
 		}
-		
-        if (best >= beta)
-        {//if the best score will already not matter, just return best:  This value will never change beta, since beta is looking for values smaller
-			horizontalcomputer = temphorizontal;
-            return best;
-        }
-        //printBoard();//debug
-		//cout << "\n";//debug
 	}
-    
-    //cout << "\n";//debug
-	horizontalcomputer = temphorizontal;	
-	return best;
+	//game over scores depend on how deep they were found.  Store them as distance from this position.
+	if (score > WINNINGSCORE)
+	{
+		score += curdepth;
+	}
+	else if (score < -WINNINGSCORE)
+	{
+		score -= curdepth;
+	}
+	bitboard data = packTransposition(score, remainingdepth, bound, bestfrom, bestto);
+	replace->key.store(key ^ data, memory_order_relaxed);
+	replace->data.store(data, memory_order_relaxed);
 }
 
-int minMove(int curdepth, int alpha)
-{//human (worst) move   
-    //cout << "MinalgoDepth " << curdepth << "\n";	
-	int temphorizontal = horizontalhuman;//placeholder, to make sure it doesn't mess up too much.		
-	int worst = ABOVEBEST;
-    movenum[curdepth] = 0;//haven't found a list of moves yet.    
-	//cout << "  MINMOVES horizontalhuman = " << horizontalhuman << " curdepth "  << curdepth << " \n";	
-	horizontalmovenum[curdepth] = 0;//haven't had a list of horizontal tie moves yet, either	
-	//TODO for some reason, this line above is changing the value of horziontalhumnan.  I don't know why.
-	horizontalhuman = temphorizontal;//replace the piece, since the above messes with it.
-	//cout << "   MINMOVES horizontalhuman = " << horizontalhuman << "\n";
-	horizontalhuman = horizontalhuman - 1;//pretend to decrement.
-	
-	if (curdepth >= MAXDEPTH)
-	{//if we reached the end of the depth we can search, evaluate this move's heuristic value.
-        //cout << "Evaluate\n";
-		horizontalhuman = temphorizontal;		
-		return evaluate( curdepth );
-	}
-    else if (checkGameOver() == 1)
-    {//if a game over occurred, then the computer won.
-		horizontalhuman = temphorizontal;			
-        return ABOVEBEST - (1+curdepth);
-    }
-	findHumanMoves(curdepth);
-	//showListOfMoves(curdepth);//debug
-	
-    if (movenum[curdepth] == 0)
-    {
-		horizontalhuman = temphorizontal;			
-        return ABOVEBEST - (1+curdepth);
-    }
-    
-    
-	for (int movecounter = LISTSIZE*curdepth; movecounter < LISTSIZE*curdepth + movenum[curdepth]; movecounter = movecounter + 5)
-	{//go through each move, and pretend to move the piece.
-
-		//put the move on the stack
-		movestack[movestackoff] = listoflegalmoves[movecounter];
-		movestack[movestackoff + 1] = listoflegalmoves[movecounter+1];
-		movestack[movestackoff+2] = listoflegalmoves[movecounter+2];
-		movestack[movestackoff+3] = listoflegalmoves[movecounter+3];
-		movestack[movestackoff+4] = boardarray[yoffoldy + movestack[movestackoff]];
-        movestack[movestackoff + 5] = boardarray[yoffnewy + movestack[movestackoff+2]];  
-        //char charx =  movestack[movestackoff] + 'A';//debug
-		//char chary =  YWIDTH - movestack[movestackoff + 1] + '0';
-		//cout << "piecetomove = " << piecetomove << " at " << charx << chary << "in depth " << curdepth << " \n";//debug
-		//cout << "Movenumber to go into method at minmove is " << movecounter % (LISTSIZE*curdepth) << "\n";//debug
-
-		if (movestack[movestackoff + 4] == 't' && horizontalhuman != 1 &&checkListOfHorizontalMoves(movecounter % (LISTSIZE*curdepth),curdepth) == 1)
-		{//if this was a horizontal move, pretend it was one by setting the horizontal value.
-			horizontalhuman = 2;
-		}
-		
-		
-		movePiece(curdepth, listoflegalmoves[movecounter+4]);//pretend to move the piece
-		int score = maxMove(curdepth + 1, worst);//go to max move, and increment depth by one.
-		
-		if (score < worst)
-		{//if the score is better than the best move
-            //cout << "Found a worse move at " << curdepth << ".  With value of "<< score << " \n";
-			worst = score;//change best to current score.
-            
+void clearTransposition()
+{//empty every entry.  Nothing can be searching:  Only bench does this, so its count doesn't depend on what was searched before.
+	for (int bucketnum = 0; bucketnum < TTNUMOFBUCKETS; bucketnum++)
+	{
+		for (int entrynum = 0; entrynum < TTBUCKETSIZE; entrynum++)
+		{
+			transpositiontable[bucketnum].entries[entrynum].key.store(0, memory_order_relaxed);
+			transpositiontable[bucketnum].entries[entrynum].data.store(0, memory_order_relaxed);
 		}
-        //printBoard();//debug        
-		resetPiecePosition(0,  curdepth, listoflegalmoves[movecounter+4]);
-		if (movestack[movestackoff + 4] == 't' && checkListOfHorizontalMoves(movecounter % (LISTSIZE*curdepth),curdepth) == 1)
-		{//if this was a horizontal move, pretend it was one by setting the horizontal value.
-			horizontalhuman = temphorizontal;
-		}
-        //printBoard();//debug
-		//cout << "\n";//debug
-        if (worst <= alpha)
-        {//if this value will no longer affect the outcome, since this value will always be less than the alpha, and alpha doesn't change unless the value is greater.
-			//cout << "pruning at minmove...\n";
-			horizontalhuman = temphorizontal;		
-            return worst;
-        }
 	}
-	
-	
-    //cout << "\n";//debug
-	horizontalhuman = temphorizontal;	
-	return worst;
+	ttgeneration = 0;
 }
 
-int makeAMove()
-{//The computer make the move
-    int best = BELOWWORST;
-    //Now, make the algorithm
-    int curdepth = 0;//since we start the algorithm here, we didn't go deeper.  But, as we search through the plies, this number will increase.
-    movenum[curdepth] = 0;//haven't found a list of moves yet.
-	horizontalmovenum[curdepth] = 0;//haven't had a list of horizontal tie moves yet, either	
-	horizontalcomputer--;//decrement horizontal computer, since it technically has been past a turn.
-	//this can be done before, since this is the real move.
-	int temphorizontal = horizontalcomputer;//place holder, since recursion will alter horizontalcomputer, may not need.
-	
-	//Take a look at each of the computer's moves, based on their pieces.
-	findComputerMoves(curdepth);//find list of computer's moves.
-	showListOfMoves(curdepth);//debug, show list of computer's moves.
-	if (checkNoMoves(1, 0) == 1)
-	{//makes sure there is a list of moves.  If not, end the game.
-		exit(0);//Opponent Won.
+void orderMoves(Position* pos, SearchContext* ctx, int curdepth, int bestfrom, int bestto)
+{//score each move (hash move, death star hits, captures by victim and attacker, killers, then history) and sort the list by it.
+	int liststart = LISTSIZE*curdepth;
+	int numofmoves = ctx->movenum[curdepth];
+	if (numofmoves < 2)
+	{
+		return;
 	}
+	Move moves[LISTSIZE];//copy of the list, to put back in order
+	int scores[LISTSIZE];
+	int order[LISTSIZE];
+	memcpy(moves, ctx->listoflegalmoves + liststart, numofmoves*sizeof(Move));
 	
-	//temp piece:  Current best move.
-	int bestpiecetomovex = listoflegalmoves[0];//go to first move, don't care otherwise.
-	int bestpiecetomovey = listoflegalmoves[1];
-	int bestpiecenewx = listoflegalmoves[2];
-	int bestpiecenewy = listoflegalmoves[3];
-	int bestpiecenum = listoflegalmoves[4];//the piecenum
-	int piecenum = 0;
-	//cout << "FIRST Current piece to move " << piecetomove << "\n";//debug
-    int bestmovenum = 0;//for horizontal checking
-	
-	for (int movecounter = 0; movecounter < movenum[curdepth]; movecounter = movecounter + 5)
-	{//go through each move, and pretend to move the piece.
-		//char xold = listoflegalmoves[movecounter] + 'A';//just like with int to char, need to displace by ASCII text
-        //char yold = (YWIDTH - listoflegalmoves[movecounter+1]) + '0';// to get inverse, a = width - b
-        //char xnew = listoflegalmoves[movecounter+2] + 'A';
-        //char ynew = (YWIDTH - listoflegalmoves[movecounter+3]) + '0';
-        //cout << " " << xold << "" << yold << "" << xnew << "" << ynew;//Debug, to see moves made
-		//cout << "HORIZONTAL HUMAN IN MAKEAMOVE LOOP CURRENTLY " << horizontalhuman << "\n";//debug
-				
-        movestack[0] = listoflegalmoves[movecounter];
-        movestack[1] = listoflegalmoves[movecounter+1];
-        movestack[2] = listoflegalmoves[movecounter+2];
-        movestack[3] = listoflegalmoves[movecounter+3];
-        movestack[4] = boardarray[yoffoldy + movestack[movestackoff]];
-        movestack[5] = boardarray[yoffnewy + movestack[movestackoff+2]];
-		piecenum = listoflegalmoves[movecounter+4];
-		/*char charx =  movestack[movestackoff] + 'A';
-		char chary =  YWIDTH - movestack[movestackoff + 1] + '0';
-		cout << "piecetomove = " << piecetomove << " at " << charx << chary << "\n";*///debug
-		if (movestack[movestackoff + 4] == 'T' && checkListOfHorizontalMoves(movecounter ,curdepth) == 1)
-		{//if this was a horizontal move, pretend it was one by setting the horizontal value.
-			horizontalcomputer = 2;
+	for (int movecount = 0; movecount < numofmoves; movecount++)
+	{
+		Move move = moves[movecount];
+		int from = moveFrom(move);
+		int to = moveTo(move);
+		int piecetype = movedPiece(move)/NUMOFPIECES;
+		if (from == bestfrom && to == bestto)
+		{
+			scores[movecount] = HASHMOVESCORE;
 		}
-		
-		movePiece( curdepth, listoflegalmoves[movecounter+4]);//pretend to move the piece
-		int score = minMove(curdepth + 1, best);//go to min move, and increment depth by one.
-		
-		if (score > best)
-		{//if the score is better than the best move
-            //cout << "Found a better move. \n";
-			best = score;//change best to current score.
-			bestpiecetomovex = listoflegalmoves[movecounter];
-			bestpiecetomovey = listoflegalmoves[movecounter+1];
-			bestpiecenewx = listoflegalmoves[movecounter+2];
-			bestpiecenewy = listoflegalmoves[movecounter+3];
-			bestpiecenum = listoflegalmoves[movecounter+4];
-			bestmovenum = movecounter;
+		else if (move & MOVEDEATHSTAR)
+		{
+			scores[movecount] = DEATHSTARSCORE;
 		}
-		resetPiecePosition(1, curdepth, listoflegalmoves[movecounter+4]);
-		if (movestack[movestackoff + 4] == 'T' && horizontalcomputer != 1 && checkListOfHorizontalMoves(movecounter ,curdepth) == 1)
-		{//if this was a horizontal move, pretend it was one by setting the horizontal value.
-			horizontalcomputer = temphorizontal;
+		else if (move & MOVECAPTURE)
+		{//find what's being captured
+			int victimtype = 0;
+			while (((pos->pieceboards[victimtype] >> to) & 1) == 0)
+			{
+				victimtype++;
+			}
+			scores[movecount] = CAPTURESCORE + PIECEVALUES[victimtype]*16 - PIECEVALUES[piecetype];
 		}
-		//cout << "\n";//debug
-	}
-	
+		else if (ctx->killermoves[curdepth][0] == from*64 + to)
+		{
+			scores[movecount] = KILLERSCORE + 1;
+		}
+		else if (ctx->killermoves[curdepth][1] == from*64 + to)
+		{
+			scores[movecount] = KILLERSCORE;
+		}
+		else
+		{
+			scores[movecount] = ctx->historytable[piecetype/2][from][to];
+		}
+		
+		//insertion sort, highest score first.  Equal scores keep the order they were found in.
+		int position = movecount;
+		while (position > 0 && scores[order[position - 1]] < scores[movecount])
+		{
+			order[position] = order[position - 1];
+			position--;
+		}
+		order[position] = movecount;
+	}
+	
+	for (int position = 0; position < numofmoves; position++)
+	{
+		ctx->listoflegalmoves[liststart + position] = moves[order[position]];
+	}
+}
+
+void rememberCutoff(SearchContext* ctx, int curdepth, int movecounter)
+{//a quiet move that caused a cutoff is likely to cause one in the positions next to this one, too.  Captures are sorted first anyway.
+	Move move = ctx->listoflegalmoves[movecounter];
+	int from = moveFrom(move);
+	int to = moveTo(move);
+	if (move & (MOVECAPTURE | MOVEDEATHSTAR))
+	{
+		return;
+	}
+	if (ctx->killermoves[curdepth][0] != from*64 + to)
+	{
+		ctx->killermoves[curdepth][1] = ctx->killermoves[curdepth][0];
+		ctx->killermoves[curdepth][0] = from*64 + to;
+	}
+	int* history = &ctx->historytable[movedPiece(move)/(NUMOFPIECES*2)][from][to];
+	*history += (ctx->searchdepth - curdepth)*(ctx->searchdepth - curdepth);//cutoffs far from the leaves count more
+	if (*history >= HISTORYMAX)
+	{
+		ageHistory(ctx);
+	}
+}
+
+void ageHistory(SearchContext* ctx)
+{//halve the history, so newer cutoffs count more than old ones.
+	for (int side = 0; side < 2; side++)
+	{
+		for (int from = 0; from < NUMOFSQUARES; from++)
+		{
+			for (int to = 0; to < NUMOFSQUARES; to++)
+			{
+				ctx->historytable[side][from][to] /= 2;
+			}
+		}
+	}
+}
+
+int negamax(Position* pos, SearchContext* ctx, int curdepth, int alpha, int beta, int whichplayer)
+{//alpha beta search for whichplayer (1 = computer, 0 = human), scored for the player to move:  The other player's score is just
+	//the negative.  Principal variation search:  After the first move, each move is searched with a null window to see if it beats alpha,
+	//and only searched again with the whole window if it does.
+    //cout << "NegamaxDepth " << curdepth << "\n";
+	if (checkTimeUp(ctx) == 1)
+	{//out of time:  Don't change anything, the result will be thrown away.
+		return 0;
+	}
+	bitboard key = positionKey(pos, whichplayer);
+    ctx->movenum[curdepth] = 0;//haven't found a list of moves yet.
+	int tbscore = 0;
+	if (tbpieces > 0 && probeTablebase(pos, whichplayer, curdepth, &tbscore) == 1)
+	{//an endgame solved ahead of time:  The score is exact, so there's nothing to search, even at the search depth.
+		ctx->stats.plynodes[curdepth]++;
+		ctx->stats.plyleaves[curdepth]++;
+		ctx->stats.tbhits++;
+		return tbscore;
+	}
+	if (curdepth >= ctx->searchdepth)
+	{//if we reached the end of the depth we can search, evaluate this move's heuristic value
+		return quiesce(pos, ctx, curdepth, alpha, beta, whichplayer);//don't stop in the middle of a trade
+	}
+	ctx->stats.plynodes[curdepth]++;
+    if (checkGameOver(pos) == 1)
+    {//if it was game over here, then the other player won.
+		ctx->stats.plyleaves[curdepth]++;
+        return BELOWWORST + 1 + curdepth;//use curdepth to indicate how much more winning it is:  earlier win(lower curdepth) = better
+    }
+	
+	int ttdepth = 0;//what the transposition table has for this position, if anything.
+	int ttscore = 0;
+	int ttbound = EXACTBOUND;
+	int hashfrom = NOSQUARE;
+	int hashto = NOSQUARE;
+	ctx->stats.ttprobes++;
+	int tthit = probeTransposition(key, curdepth, &ttdepth, &ttscore, &ttbound, &hashfrom, &hashto);
+	ctx->stats.tthits += tthit;
+	if (tthit == 1 && ttdepth >= ctx->searchdepth - curdepth
+		&& (ttbound == EXACTBOUND || (ttbound == LOWERBOUND && ttscore >= beta) || (ttbound == UPPERBOUND && ttscore <= alpha)))
+	{//if this position was already searched at least as deep, and the score can be used with this window.
+		ctx->stats.ttcutoffs++;
+		return ttscore;
+	}
+	
+	if (whichplayer == 1)
+	{
+		findComputerMoves(pos, ctx, curdepth);
+	}
+	else
+	{
+		findHumanMoves(pos, ctx, curdepth);
+	}
+	//showListOfMoves(curdepth);//debug
+    if (ctx->movenum[curdepth] == 0)
+    {//no moves:  The player to move lost.
+		ctx->stats.plyleaves[curdepth]++;
+        return BELOWWORST + 1 + curdepth;
+    }
+    orderMoves(pos, ctx, curdepth, hashfrom, hashto);//try the move that was best last time first, then the ones that look best.
+    
+	int best = BELOWWORST;
+    int bestmove = LISTSIZE*curdepth;//where the best move is in the list of moves, for the transposition table
+	int originalalpha = alpha;//to tell if the score is exact, or only an upper bound
+	for (int movecounter = LISTSIZE*curdepth; movecounter < LISTSIZE*curdepth + ctx->movenum[curdepth]; movecounter++)
+	{//go through each move, and pretend to move the piece.
+		ctx->movestack[curdepth] = ctx->listoflegalmoves[movecounter];//put the move on the stack
+		movePiece(pos, ctx, curdepth);//pretend to move the piece.  A horizontal move sets the horizontal value, and undoing it puts it back.
+		int score = 0;
+		if (movecounter == LISTSIZE*curdepth)
+		{//the first move is expected to be the best:  search it with the whole window.
+			score = -negamax(pos, ctx, curdepth + 1, -beta, -alpha, 1 - whichplayer);
+		}
+		else
+		{//the rest only have to show they can't beat alpha.
+			score = -negamax(pos, ctx, curdepth + 1, -alpha - 1, -alpha, 1 - whichplayer);
+			if (score > alpha && score < beta && ctx->searchaborted == 0)
+			{//it did beat alpha:  find out by how much.
+				score = -negamax(pos, ctx, curdepth + 1, -beta, -alpha, 1 - whichplayer);
+			}
+		}
+		resetPiecePosition(pos, ctx, curdepth);
+		if (ctx->searchaborted != 0)
+		{//the search ran out of time below here, so this isn't a real score.  Don't remember it.
+			return best;
+		}
+		
+		if (score > best)
+		{//if the score is better than the best move
+			best = score;//change best to current score.
+			bestmove = movecounter;
+		}
+		if (best > alpha)
+		{
+			alpha = best;
+		}
+		if (movecounter == LISTSIZE*curdepth && alpha < beta && canSplit(ctx, curdepth) == 1)
+		{//Young Brothers Wait:  the first move is searched, now the rest can be searched in parallel.
+			int splitbestmove = bestmove - LISTSIZE*curdepth;
+			splitSearch(pos, ctx, curdepth, whichplayer, 1, alpha, beta, &best, &splitbestmove);
+			bestmove = LISTSIZE*curdepth + splitbestmove;
+			if (ctx->searchaborted != 0)
+			{
+				return best;
+			}
+			if (best > alpha)
+			{
+				alpha = best;
+			}
+			movecounter = LISTSIZE*curdepth + ctx->movenum[curdepth];//every move is searched.  Still check for a cutoff below, then leave the loop.
+		}
+		
+        if (alpha >= beta)
+        {//the other player won't let the game get here, since they already have something better.  The rest of the moves don't matter.
+			ctx->stats.betacutoffs++;
+			if (bestmove == LISTSIZE*curdepth)
+			{
+				ctx->stats.firstmovecutoffs++;
+			}
+			rememberCutoff(ctx, curdepth, bestmove);
+			storeTransposition(key, curdepth, ctx->searchdepth - curdepth, best, LOWERBOUND, moveFrom(ctx->listoflegalmoves[bestmove]), moveTo(ctx->listoflegalmoves[bestmove]));
+            return best;
+        }
+	}
+    
+	int bound = EXACTBOUND;
+	if (best <= originalalpha)
+	{//nothing beat alpha, so the real score could be even lower.
+		bound = UPPERBOUND;
+		ctx->stats.alphanodes++;
+	}
+	storeTransposition(key, curdepth, ctx->searchdepth - curdepth, best, bound, moveFrom(ctx->listoflegalmoves[bestmove]), moveTo(ctx->listoflegalmoves[bestmove]));
+	return best;
+}
+
+int quiesce(Position* pos, SearchContext* ctx, int curdepth, int alpha, int beta, int whichplayer)
+{//quiescence search:  past the search depth, keep going only through captures and death star hits, so the evaluation isn't taken
+	//in the middle of a trade.  The player to move can also stand pat (not capture), so the evaluation is the least they get.
+	if (curdepth > ctx->searchdepth && checkTimeUp(ctx) == 1)
+	{//the node at the search depth was already counted by negamax.
+		return 0;
+	}
+	ctx->stats.plynodes[curdepth]++;
+	if (curdepth > ctx->searchdepth)
+	{
+		ctx->stats.quiescencenodes++;
+	}
+	if (checkGameOver(pos) == 1)
+	{//the other player hit the death star, or took everything.
+		ctx->stats.plyleaves[curdepth]++;
+		return BELOWWORST + 1 + curdepth;
+	}
+	int standpat = evaluate(pos, curdepth);//evaluate is for the computer
+	if (whichplayer == 0)
+	{
+		standpat = -standpat;
+	}
+	if (standpat >= beta || curdepth >= MAXDEPTH - 1)
+	{
+		ctx->stats.plyleaves[curdepth]++;
+		return standpat;
+	}
+	if (standpat > alpha)
+	{
+		alpha = standpat;
+	}
+	int best = standpat;
+	int capturegain = -CAPTUREVALUES[2];//how much a capture is worth to the player to move
+	if (whichplayer == 1)
+	{
+		capturegain = CAPTUREVALUES[0];
+	}
+	ctx->movenum[curdepth] = 0;
+	findCaptures(pos, ctx, whichplayer, curdepth);
+	orderMoves(pos, ctx, curdepth, NOSQUARE, NOSQUARE);//death star hits, then the most valuable victims
+	int searchedmoves = 0;//a node with nothing worth searching is a leaf.
+	for (int movecounter = LISTSIZE*curdepth; movecounter < LISTSIZE*curdepth + ctx->movenum[curdepth]; movecounter++)
+	{
+		if (deltapruning == 1 && (ctx->listoflegalmoves[movecounter] & MOVEDEATHSTAR) == 0 && standpat + capturegain <= alpha)
+		{//delta pruning:  the other player can stand pat after this, so one more piece can't get above alpha.
+			continue;
+		}
+		ctx->movestack[curdepth] = ctx->listoflegalmoves[movecounter];
+		movePiece(pos, ctx, curdepth);
+		int score = -quiesce(pos, ctx, curdepth + 1, -beta, -alpha, 1 - whichplayer);
+		searchedmoves++;
+		resetPiecePosition(pos, ctx, curdepth);
+		if (score > best)
+		{
+			best = score;
+		}
+		if (best > alpha)
+		{
+			alpha = best;
+		}
+		if (ctx->searchaborted != 0 || alpha >= beta)
+		{
+			break;
+		}
+	}
+	if (searchedmoves == 0)
+	{
+		ctx->stats.plyleaves[curdepth]++;
+	}
+	return best;
+}
+
+long long elapsedMilliseconds(SearchContext* ctx)
+{//how long the current move's search has been going.
+	return chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - ctx->searchstart).count();
+}
+
+int checkTimeUp(SearchContext* ctx)
+{//count the node, and look at the clock every 1024 nodes.  Depth 1 always finishes, so there is always a move to make.
+	ctx->nodecount++;
+	if (ctx->searchaborted == 0 && ctx->searchdepth > 1 && (ctx->nodecount & 1023) == 0)
+	{
+		if (elapsedMilliseconds(ctx) >= ctx->movetime || (ctx->stopflag != NULL && *ctx->stopflag == 1) || (ctx->nodelimit > 0 && ctx->nodecount >= ctx->nodelimit))
+		{
+			ctx->searchaborted = 1;
+		}
+		else if (checkSplitCutoff(ctx->currentsplit) == 1)
+		{//another thread found a cutoff above here:  This search doesn't matter any more.
+			ctx->searchaborted = 2;
+		}
+	}
+	return ctx->searchaborted != 0;
+}
+
+int searchRoot(Position* pos, SearchContext* ctx, int whichplayer, int alpha, int beta, int* bestmove)
+{//search whichplayer's list of moves at depth 0 with the window alpha to beta, the same way negamax does.  bestmove is where the
+	//best one is in the list.
+	int curdepth = 0;
+	int best = BELOWWORST;
+	*bestmove = 0;
+	for (int movecounter = 0; movecounter < ctx->movenum[curdepth]; movecounter++)
+	{//go through each move, and pretend to move the piece.
+		ctx->movestack[curdepth] = ctx->listoflegalmoves[movecounter];
+		movePiece(pos, ctx, curdepth);//pretend to move the piece
+		int score = 0;
+		if (movecounter == 0)
+		{
+			score = -negamax(pos, ctx, curdepth + 1, -beta, -alpha, 1 - whichplayer);
+		}
+		else
+		{//principal variation search, like in negamax
+			score = -negamax(pos, ctx, curdepth + 1, -alpha - 1, -alpha, 1 - whichplayer);
+			if (score > alpha && score < beta && ctx->searchaborted == 0)
+			{
+				score = -negamax(pos, ctx, curdepth + 1, -beta, -alpha, 1 - whichplayer);
+			}
+		}
+		resetPiecePosition(pos, ctx, curdepth);
+		if (ctx->searchaborted != 0)
+		{//out of time part way through this depth:  Throw it away, and use the last depth that finished.
+			return best;
+		}
+		
+		if (score > best)
+		{//if the score is better than the best move
+			best = score;//change best to current score.
+			*bestmove = movecounter;
+		}
+		if (best > alpha)
+		{
+			alpha = best;
+		}
+		if (movecounter == 0 && alpha < beta && canSplit(ctx, curdepth) == 1)
+		{//Young Brothers Wait:  the first move is searched, now the rest can be searched in parallel.
+			splitSearch(pos, ctx, curdepth, whichplayer, 1, alpha, beta, &best, bestmove);
+			return best;
+		}
+		if (alpha >= beta)
+		{//only happens with an aspiration window:  The real score is at least this much.
+			return best;
+		}
+	}
+	return best;
+}
+
+void searchMoves(Position* pos, SearchContext* ctx, int whichplayer, SearchResult* result, int firstdepth)
+{//Iterative deepening:  search depth firstdepth, firstdepth + 1... until time runs out.  The transposition table makes the earlier depths cheap,
+	//and it tries the last depth's best move first.  The list of moves at depth 0 has to be found already, and result starts with a move from it.
+	//Aspiration windows:  Each depth is first searched with a small window around the last depth's score.  If the score lands outside it,
+	//that side of the window is opened up and the depth is searched again.
+	int curdepth = 0;
+	for (ctx->searchdepth = firstdepth; ctx->searchdepth <= ctx->maxsearchdepth; ctx->searchdepth++)
+	{
+		long long startnodes = ctx->nodecount;
+		int alpha = BELOWWORST;
+		int beta = ABOVEBEST;
+		if (result->depth > 0 && result->score < WINNINGSCORE && result->score > -WINNINGSCORE)
+		{
+			alpha = result->score - ASPIRATIONWINDOW;
+			beta = result->score + ASPIRATIONWINDOW;
+		}
+		int best = BELOWWORST;
+		int bestmove = 0;
+		int hashfrom = moveFrom(result->move);//the last depth's best move goes first
+		int hashto = moveTo(result->move);
+		for (;;)
+		{
+			orderMoves(pos, ctx, curdepth, hashfrom, hashto);
+			best = searchRoot(pos, ctx, whichplayer, alpha, beta, &bestmove);
+			if (ctx->searchaborted != 0)
+			{
+				break;
+			}
+			hashfrom = moveFrom(ctx->listoflegalmoves[bestmove]);//if it has to search again, start with this one.
+			hashto = moveTo(ctx->listoflegalmoves[bestmove]);
+			if (best <= alpha && alpha > BELOWWORST)
+			{//failed low:  Every move is worse than the window.
+				alpha = BELOWWORST;
+			}
+			else if (best >= beta && beta < ABOVEBEST)
+			{//failed high
+				beta = ABOVEBEST;
+			}
+			else
+			{
+				break;
+			}
+		}
+		
+		if (ctx->searchaborted != 0)
+		{
+			break;
+		}
+		result->move = ctx->listoflegalmoves[bestmove];
+		result->score = best;
+		result->depth = ctx->searchdepth;
+		ctx->stats.iterationnodes[ctx->searchdepth] = ctx->nodecount - startnodes;
+		ctx->stats.depth = ctx->searchdepth;
+		if (ctx->printinfo == 1)
+		{
+			printSearchInfo(pos, ctx, whichplayer, result);
+		}
+		if (best > WINNINGSCORE || best < -WINNINGSCORE || elapsedMilliseconds(ctx)*2 >= ctx->movetime)
+		{//the game is decided, or the next depth would take more than the time left (each depth takes a few times longer).
+			break;
+		}
+	}
+}
+
+void searchWithHelpers(Position* pos, SearchContext* ctx, int whichplayer, SearchResult* result, int firstdepth)
+{//searchMoves, with numofthreads - 1 more threads helping the way -parallel says.  Whichever thread got the deepest gives the result,
+	//and the helpers' nodes and stats are added to ctx's.
+	thread helperthreads[MAXTHREADS];
+	helperstop = 0;
+	if (numofthreads > 1 && firstdepth <= ctx->maxsearchdepth && parallelmode == LAZYSMP)
+	{//start the helpers on the same position.
+		rootsnapshot = *pos;
+		rootplayer = whichplayer;
+		for (int threadnum = 1; threadnum < numofthreads; threadnum++)
+		{
+			helperthreads[threadnum] = thread(helpSearch, threadnum, ctx);
+		}
+	}
+	else if (numofthreads > 1 && firstdepth <= ctx->maxsearchdepth && parallelmode == YOUNGBROTHERSWAIT)
+	{//start the workers.  They wait for nodes to be split.
+		splitting = 1;
+		for (int threadnum = 1; threadnum < numofthreads; threadnum++)
+		{
+			helperthreads[threadnum] = thread(workerSearch, threadnum, ctx);
+		}
+	}
+	searchMoves(pos, ctx, whichplayer, result, firstdepth);
+	helperstop = 1;
+	for (int threadnum = 1; threadnum < numofthreads; threadnum++)
+	{//wait for the helpers, and use whichever thread got the deepest.
+		if (helperthreads[threadnum].joinable())
+		{
+			helperthreads[threadnum].join();
+			ctx->nodecount += helpernodes[threadnum];
+			addSearchStats(&ctx->stats, &helperstats[threadnum]);
+			if (helperresults[threadnum].depth > result->depth)
+			{
+				*result = helperresults[threadnum];
+			}
+		}
+	}
+	splitting = 0;
+}
+
+int makeAMove(Position* pos, SearchContext* ctx)
+{//The computer make the move
+    int best = BELOWWORST;
+    //Now, make the algorithm
+    int curdepth = 0;//since we start the algorithm here, we didn't go deeper.  But, as we search through the plies, this number will increase.
+    ctx->movenum[curdepth] = 0;//haven't found a list of moves yet.
+	ttgeneration++;//a new search:  Entries from earlier moves get replaced first.
+	ageHistory(ctx);
+	memset(ctx->killermoves, 0, sizeof(ctx->killermoves));//the killers were for depths counted from the last move's position
+	//this can be done before, since this is the real move.
+	
+	//Take a look at each of the computer's moves, based on their pieces.
+	findComputerMoves(pos, ctx, curdepth);//find list of computer's moves.
+	showListOfMoves(pos, ctx, curdepth);//debug, show list of computer's moves.
+	if (checkNoMoves(ctx, 1, 0) == 1)
+	{//makes sure there is a list of moves.  If not, end the game.
+		exit(0);//Opponent Won.
+	}
+	
+	//temp piece:  Current best move.
+	SearchResult result;
+	result.key = positionKey(pos, 1);
+	result.move = ctx->listoflegalmoves[0];//go to first move, don't care otherwise.
+	result.score = BELOWWORST;
+	result.depth = 0;
+	result.complete = 0;
+	int firstdepth = 1;
+	if (probeBook(ctx, result.key, &result) == 1)
+	{//searched ahead of time:  Just make the move.
+		firstdepth = ctx->maxsearchdepth + 1;
+		cout << "book move, searched to depth " << result.depth << " ahead of time\n";
+	}
+	for (int resultnum = 0; resultnum < numofponderresults && firstdepth <= ctx->maxsearchdepth; resultnum++)
+	{//if the ponder thread already searched this position, carry on from where it got to.
+		if (ponderresults[resultnum].key == result.key)
+		{
+			result = ponderresults[resultnum];
+			firstdepth = result.depth + 1;
+			if (result.complete == 1)
+			{//it got as far as this search would have:  Just make the move.
+				firstdepth = ctx->maxsearchdepth + 1;
+			}
+			cout << "pondered this move to depth " << result.depth << "\n";
+		}
+	}
+	numofponderresults = 0;
+	
+	ctx->searchstart = chrono::steady_clock::now();
+	ctx->nodecount = 0;
+	ctx->searchaborted = 0;
+	memset(&ctx->stats, 0, sizeof(ctx->stats));
+	searchWithHelpers(pos, ctx, 1, &result, firstdepth);
+	best = result.score;
+	int bestpiecetomovex = moveFrom(result.move) % XWIDTH;
+	int bestpiecetomovey = moveFrom(result.move) / XWIDTH;
+	int bestpiecenewx = moveTo(result.move) % XWIDTH;
+	int bestpiecenewy = moveTo(result.move) / XWIDTH;
+	
+	int bestmovenum = findListedMove(ctx, &result);//find the best move in the list again, to play it
+	
+	char xold = bestpiecetomovex + 'A';//just like with int to char, need to displace by ASCII text
+	char xoldinv = 'G' - bestpiecetomovex;
+    char yold = (YWIDTH - bestpiecetomovey) + '0';// to get inverse, a = width - b
+	char yoldinv = '8' - (YWIDTH - bestpiecetomovey);
+    char xnew = bestpiecenewx + 'A';
+	char xnewinv = 'G' - bestpiecenewx;
+    char ynew = (YWIDTH - bestpiecenewy) + '0';
+	char ynewinv = '8' - (YWIDTH - bestpiecenewy);
+    //cout << " " << xold << "" << yold << "" << xnew << "" << ynew;//Debug, to see moves made
+	
+	playListedMove(pos, ctx, bestmovenum);//Now make the real move.
+	
+    cout << "I made my move " << xold << yold << xnew << ynew << " ( " << xoldinv << yoldinv << xnewinv << ynewinv << " )\n";
+	cout << "evaluation result is " << best << "\n";
+	cout << "searched to depth " << result.depth << " in " << elapsedMilliseconds(ctx) << " ms, " << ctx->nodecount << " nodes\n";
+	ctx->stats.milliseconds = elapsedMilliseconds(ctx);
+	if (jsonstats == 1)
+	{
+		printStatsJson(&ctx->stats, &result, ctx->nodecount);
+	}
+    //showPieces();//debug
+	//showListStack(MAXDEPTH);//debug
+    //showAllMoves();//debug
+	return best;
+}
+
+void playListedMove(Position* pos, SearchContext* ctx, int movecounter)
+{//make the move at movecounter in the list of moves at depth 0 for real.  movePiece sets the horizontal value if it was a horizontal tie move.
+	int curdepth = 0;
+	ctx->movestack[curdepth] = ctx->listoflegalmoves[movecounter];//Put the move on the stack, to use it
+	movePiece(pos, ctx, curdepth);//now really move the piece.
+}
+
+void playHumanReply(Position* pos, SearchContext* ctx, Move reply)
+{//make a human move from a saved list of moves, the same way main makes the real one, so the position (and key) match makeAMove's.
+	ctx->movestack[0] = reply;
+	movePiece(pos, ctx, 0);
+}
+
+void ponder()
+{//the ponder thread:  guess the human's best replies with a short search, then search the computer's answer to each of them
+	//until the human moves.  makeAMove uses the answer if the human made one of these replies.
+	Position position = pondersnapshot;//this thread's own copy of the position and search state
+	SearchContext context = {};
+	Position* pos = &position;
+	SearchContext* ctx = &context;
+	ctx->stopflag = &ponderstop;
+	ctx->movetime = movetime;
+	ctx->maxsearchdepth = maxsearchdepth;
+	ctx->searchstart = chrono::steady_clock::now();
+	ctx->nodecount = 0;
+	ctx->searchaborted = 0;
+	ctx->movenum[0] = 0;
+	findHumanMoves(pos, ctx, 0);
+	
+	int numofreplies = ctx->movenum[0];
+	Move replies[LISTSIZE];//the human's moves.  Searching writes over the list at depth 0, so keep a copy.
+	int replyscores[LISTSIZE];
+	int replyorder[LISTSIZE];
+	for (int replynum = 0; replynum < numofreplies; replynum++)
+	{
+		replies[replynum] = ctx->listoflegalmoves[replynum];
+		replyorder[replynum] = replynum;
+	}
+	
+	ctx->searchdepth = min(PONDERGUESSDEPTH, ctx->maxsearchdepth);
+	for (int replynum = 0; replynum < numofreplies; replynum++)
+	{//the lower the score, the better the reply is for the human.
+		playHumanReply(pos, ctx, replies[replynum]);
+		replyscores[replynum] = negamax(pos, ctx, 1, BELOWWORST, ABOVEBEST, 1);
+		position = pondersnapshot;
+	}
+	if (ctx->searchaborted != 0)
+	{//the human moved already
+		return;
+	}
+	stable_sort(replyorder, replyorder + numofreplies, [&](int first, int second) { return replyscores[first] < replyscores[second]; });
+	
+	for (int rank = 0; rank < numofreplies && rank < PONDERREPLIES && ponderstop == 0; rank++)
+	{//search the computer's answer to each guessed reply, like makeAMove would.
+		position = pondersnapshot;
+		playHumanReply(pos, ctx, replies[replyorder[rank]]);
+		ctx->movenum[0] = 0;
+		if (checkGameOver(pos) == 1)
+		{
+			continue;
+		}
+		findComputerMoves(pos, ctx, 0);
+		if (ctx->movenum[0] == 0)
+		{
+			continue;
+		}
+		
+		SearchResult* result = &ponderresults[numofponderresults];
+		result->key = positionKey(pos, 1);
+		result->move = ctx->listoflegalmoves[0];
+		result->score = BELOWWORST;
+		result->depth = 0;
+		ctx->searchstart = chrono::steady_clock::now();
+		ctx->nodecount = 0;
+		ctx->searchaborted = 0;
+		searchMoves(pos, ctx, 1, result, 1);
+		result->complete = 1 - ponderstop;
+		if (result->depth > 0)
+		{
+			numofponderresults++;
+		}
+	}
+}
+
+void startPondering(Position* pos)
+{//hand the current position to a new ponder thread.
+	pondersnapshot = *pos;
+	numofponderresults = 0;
+	ponderstop = 0;
+	ponderthread = new thread(ponder);
+}
+
+void helpSearch(int threadnum, const SearchContext* parent)
+{//a Lazy SMP helper:  search the root position from this thread's own copy until searchWithHelpers is done.  Half the helpers start a depth
+	//ahead, and each starts with a different first move, so they don't all search the same tree in the same order.
+	Position position = rootsnapshot;
+	SearchContext context = {};
+	Position* pos = &position;
+	SearchContext* ctx = &context;
+	ctx->stopflag = &helperstop;
+	ctx->movetime = parent->movetime;
+	ctx->maxsearchdepth = parent->maxsearchdepth;
+	ctx->movenum[0] = 0;
+	if (rootplayer == 1)
+	{
+		findComputerMoves(pos, ctx, 0);
+	}
+	else
+	{
+		findHumanMoves(pos, ctx, 0);
+	}
+	
+	SearchResult* result = &helperresults[threadnum];
+	result->key = positionKey(pos, rootplayer);
+	result->move = ctx->listoflegalmoves[threadnum % ctx->movenum[0]];
+	result->score = BELOWWORST;
+	result->depth = 0;
+	result->complete = 0;
+	ctx->searchstart = parent->searchstart;
+	ctx->nodecount = 0;
+	ctx->searchaborted = 0;
+	searchMoves(pos, ctx, rootplayer, result, 1 + threadnum % 2);
+	helpernodes[threadnum] = ctx->nodecount;
+	helperstats[threadnum] = ctx->stats;
+}
+
+int canSplit(SearchContext* ctx, int curdepth)
+{//split only while the workers are running, with enough depth left to be worth copying the position, and only if there's room on the deque.
+	return splitting == 1 && ctx->searchdepth - curdepth >= SPLITMINDEPTH && ctx->movenum[curdepth] > 1
+		&& workdeques[ctx->searchthreadnum].numofsplits < MAXDEPTH;
+}
+
+int checkSplitCutoff(SplitPoint* split)
+{//a cutoff at any split point above the search means its result won't be used.
+	for (; split != NULL; split = split->parent)
+	{
+		if (split->cutoff == 1)
+		{
+			return 1;
+		}
+	}
+	return 0;
+}
+
+int isUnderSplit(SplitPoint* split, SplitPoint* ancestor)
+{
+	for (split = split->parent; split != NULL; split = split->parent)
+	{
+		if (split == ancestor)
+		{
+			return 1;
+		}
+	}
+	return 0;
+}
+
+void splitSearch(Position* pos, SearchContext* ctx, int curdepth, int whichplayer, int firstmove, int alpha, int beta, int* best, int* bestmove)
+{//Young Brothers Wait:  put the rest of this node's moves (from firstmove on, counted from the start of this depth's list) on this thread's deque
+	//for other threads to steal.  This thread searches them too, then helps the threads still searching its moves instead of just waiting.
+	//best and bestmove (also counted from the start of the list) come back with the result of all the moves.
+	SplitPoint split;
+	split.position = *pos;
+	split.parent = ctx->currentsplit;
+	split.curdepth = curdepth;
+	split.searchdepth = ctx->searchdepth;
+	split.whichplayer = whichplayer;
+	split.alpha = alpha;
+	split.beta = beta;
+	split.numofmoves = ctx->movenum[curdepth];
+	memcpy(split.moves, ctx->listoflegalmoves + LISTSIZE*curdepth, ctx->movenum[curdepth]*sizeof(Move));//the moves carry their own horizontal flag
+	split.nextmove = firstmove;
+	split.pending = 0;
+	split.best = *best;
+	split.bestmove = *bestmove;
+	split.cutoff = 0;
+	split.timeup = 0;
+	
+	WorkDeque* deque = &workdeques[ctx->searchthreadnum];
+	deque->lock.lock();
+	deque->splits[deque->numofsplits] = &split;
+	deque->numofsplits++;
+	deque->lock.unlock();
+	for (int movecounter = split.nextmove.fetch_add(1); movecounter < split.numofmoves && ctx->searchaborted != 1 && checkSplitCutoff(&split) == 0;
+		movecounter = split.nextmove.fetch_add(1))
+	{
+		searchSplitMove(ctx, &split, movecounter);
+	}
+	deque->lock.lock();//nobody can steal from it after this, so it only has to wait for the moves already taken.
+	deque->numofsplits--;
+	deque->lock.unlock();
+	while (split.pending > 0)
+	{
+		if (stealWork(ctx, &split) == 0)
+		{
+			this_thread::yield();
+		}
+	}
+	
+	if (ctx->searchaborted == 2)
+	{
+		ctx->searchaborted = 0;
+	}
+	if (split.timeup == 1)
+	{
+		ctx->searchaborted = 1;
+	}
+	else if (ctx->searchaborted == 0 && checkSplitCutoff(split.parent) == 1)
+	{
+		ctx->searchaborted = 2;
+	}
+	*best = split.best;
+	*bestmove = split.bestmove;
+}
+
+void searchSplitMove(SearchContext* ctx, SplitPoint* split, int movecounter)
+{//search one of a split point's moves from a copy of the position, the same way negamax would.  The copy is made here, so the
+	//position of whatever this thread was searching before (the owner's node, or the node it is waiting on) isn't touched.
+	Position position = split->position;
+	Position* pos = &position;
+	SplitPoint* previoussplit = ctx->currentsplit;
+	ctx->currentsplit = split;
+	ctx->searchdepth = split->searchdepth;
+	int curdepth = split->curdepth;
+	int whichplayer = split->whichplayer;
+	ctx->movestack[curdepth] = split->moves[movecounter];
+	movePiece(pos, ctx, curdepth);
+	int alpha = split->alpha;
+	int score = -negamax(pos, ctx, curdepth + 1, -alpha - 1, -alpha, 1 - whichplayer);//null window, like the moves after the first in negamax
+	if (score > alpha && score < split->beta && ctx->searchaborted == 0)
+	{
+		score = -negamax(pos, ctx, curdepth + 1, -split->beta, -alpha, 1 - whichplayer);
+	}
+	ctx->currentsplit = previoussplit;
+	
+	if (ctx->searchaborted == 1)
+	{
+		split->timeup = 1;
+		return;
+	}
+	if (ctx->searchaborted == 2)
+	{//a cutoff stopped it, so the score doesn't count.
+		ctx->searchaborted = 0;
+		return;
+	}
+	lock_guard<mutex> guard(split->lock);
+	if (score > split->best)
+	{
+		split->best = score;
+		split->bestmove = movecounter;
+	}
+	if (score > split->alpha)
+	{
+		split->alpha = score;
+		if (score >= split->beta)
+		{
+			split->cutoff = 1;
+		}
+	}
+}
+
+int stealWork(SearchContext* ctx, SplitPoint* helping)
+{//take a move from the oldest split point of another thread that has one, and search it.  If helping isn't NULL, only take moves
+	//from split points under it:  This thread is waiting on it, so it can't start on anything that might take longer.
+	for (int victimoffset = 1; victimoffset < numofthreads; victimoffset++)
+	{
+		WorkDeque* deque = &workdeques[(ctx->searchthreadnum + victimoffset) % numofthreads];
+		deque->lock.lock();
+		for (int splitnum = 0; splitnum < deque->numofsplits; splitnum++)
+		{
+			SplitPoint* split = deque->splits[splitnum];
+			if ((helping == NULL || isUnderSplit(split, helping) == 1) && checkSplitCutoff(split) == 0)
+			{
+				int movecounter = split->nextmove.fetch_add(1);
+				if (movecounter < split->numofmoves)
+				{
+					split->pending++;//before unlocking, so the owner knows to wait for it.
+					deque->lock.unlock();
+					searchSplitMove(ctx, split, movecounter);
+					split->pending--;
+					return 1;
+				}
+			}
+		}
+		deque->lock.unlock();
+	}
+	return 0;
+}
+
+void workerSearch(int threadnum, const SearchContext* parent)
+{//a Young Brothers Wait worker:  steal moves from split points until makeAMove is done.
+	SearchContext context = {};
+	SearchContext* ctx = &context;
+	ctx->searchthreadnum = threadnum;
+	ctx->stopflag = &helperstop;
+	ctx->movetime = parent->movetime;
+	ctx->maxsearchdepth = parent->maxsearchdepth;
+	ctx->searchstart = parent->searchstart;
+	ctx->nodecount = 0;
+	helperresults[threadnum].depth = 0;//only the main thread's result is used
+	while (helperstop == 0)
+	{
+		ctx->searchaborted = 0;
+		if (stealWork(ctx, NULL) == 0)
+		{
+			this_thread::yield();
+		}
+	}
+	helpernodes[threadnum] = ctx->nodecount;
+	helperstats[threadnum] = ctx->stats;
+}
+
+void stopPondering()
+{//tell the ponder thread the human moved, and wait for it to finish.
+	if (ponderthread != NULL)
+	{
+		ponderstop = 1;
+		ponderthread->join();
+		delete ponderthread;
+		ponderthread = NULL;
+	}
+}
+
+int findListedMove(SearchContext* ctx, const SearchResult* result)
+{//find the result's move in the list of moves at depth 0.  The list may have been sorted since, or the move found by another thread's list.
+	for (int movecounter = 0; movecounter < ctx->movenum[0]; movecounter++)
+	{
+		if ((ctx->listoflegalmoves[movecounter] & MOVESQUARES) == (result->move & MOVESQUARES))
+		{
+			return movecounter;
+		}
+	}
+	return 0;
+}
+
+void addSearchStats(SearchStats* total, const SearchStats* part)
+{//add one search's (or one thread's) counters to total.  The depth is the deepest either got to.
+	for (int plynum = 0; plynum <= MAXDEPTH; plynum++)
+	{
+		total->plynodes[plynum] += part->plynodes[plynum];
+		total->plyleaves[plynum] += part->plyleaves[plynum];
+		total->iterationnodes[plynum] += part->iterationnodes[plynum];
+	}
+	total->betacutoffs += part->betacutoffs;
+	total->firstmovecutoffs += part->firstmovecutoffs;
+	total->alphanodes += part->alphanodes;
+	total->ttprobes += part->ttprobes;
+	total->tthits += part->tthits;
+	total->ttcutoffs += part->ttcutoffs;
+	total->quiescencenodes += part->quiescencenodes;
+	total->tbhits += part->tbhits;
+	total->depth = max(total->depth, part->depth);
+	total->milliseconds += part->milliseconds;
+}
+
+void printStatsJson(const SearchStats* stats, const SearchResult* result, long long nodes)
+{//one line of JSON for the move just made, so a script can collect them.  The effective branching factor is how many times more nodes
+	//the last finished depth took than the one before it.  The per ply arrays stop at the deepest ply that was reached.
+	long long leaves = 0;
+	int lastply = 0;
+	for (int plynum = 0; plynum <= MAXDEPTH; plynum++)
+	{
+		leaves += stats->plyleaves[plynum];
+		if (stats->plynodes[plynum] > 0)
+		{
+			lastply = plynum;
+		}
+	}
+	double branchingfactor = 0;
+	if (stats->depth > 1 && stats->iterationnodes[stats->depth - 1] > 0)
+	{
+		branchingfactor = (double)stats->iterationnodes[stats->depth]/stats->iterationnodes[stats->depth - 1];
+	}
+	cout << "{\"move\":\"" << (char)(moveFrom(result->move) % XWIDTH + 'A') << YWIDTH - moveFrom(result->move) / XWIDTH 
+		<< (char)(moveTo(result->move) % XWIDTH + 'A') << YWIDTH - moveTo(result->move) / XWIDTH << "\""
+		<< ",\"score\":" << result->score << ",\"depth\":" << result->depth << ",\"ms\":" << stats->milliseconds << ",\"nodes\":" << nodes
+		<< ",\"nps\":" << nodes*1000/max(stats->milliseconds, 1LL) << ",\"leaves\":" << leaves
+		<< ",\"betacutoffs\":" << stats->betacutoffs << ",\"firstmovecutoffs\":" << stats->firstmovecutoffs
+		<< ",\"firstmovecutoffrate\":" << (double)stats->firstmovecutoffs/max(stats->betacutoffs, 1LL)
+		<< ",\"alphanodes\":" << stats->alphanodes << ",\"ebf\":" << branchingfactor
+		<< ",\"ttprobes\":" << stats->ttprobes << ",\"tthits\":" << stats->tthits << ",\"ttcutoffs\":" << stats->ttcutoffs
+		<< ",\"quiescencenodes\":" << stats->quiescencenodes << ",\"tbhits\":" << stats->tbhits << ",\"plynodes\":[";
+	for (int plynum = 0; plynum <= lastply; plynum++)
+	{
+		cout << (plynum > 0 ? "," : "") << stats->plynodes[plynum];
+	}
+	cout << "],\"plyleaves\":[";
+	for (int plynum = 0; plynum <= lastply; plynum++)
+	{
+		cout << (plynum > 0 ? "," : "") << stats->plyleaves[plynum];
+	}
+	cout << "]}\n";
+}
+
+int selfPlayGame(Position* pos, SearchContext* ctx, int gamenum, SelfPlayStats* stats)
+{//play one game of the engine against itself, the same way main and makeAMove play a real one.  The first openingplies moves are random,
+	//and the sides take turns going first.  Returns the winner, 0 = human side, 1 = computer side, or -1 if it ran too long.
+	setup(pos);
+	pos->horizontalhuman = 0;
+	pos->horizontalcomputer = 0;
+	memset(ctx->historytable, 0, sizeof(ctx->historytable));
+	bitboard randomstate = selfplayseed*0x100000001ULL + gamenum;
+	int whichplayer = gamenum % 2;
+	for (int ply = 0; ply < MAXGAMEPLIES; ply++)
+	{
+		ctx->movenum[0] = 0;
+		if (whichplayer == 1)
+		{
+			findComputerMoves(pos, ctx, 0);
+		}
+		else
+		{
+			findHumanMoves(pos, ctx, 0);
+		}
+		if (ctx->movenum[0] == 0)
+		{//no moves:  the other side wins.
+			stats->plies += ply;
+			return 1 - whichplayer;
+		}
+		
+		int movecounter = 0;
+		if (ply < openingplies)
+		{
+			movecounter = (int)(splitMix(randomstate) % ctx->movenum[0]);
+		}
+		else
+		{//search it like makeAMove, with this side's time and depth.
+			SearchResult result;
+			result.key = positionKey(pos, whichplayer);
+			result.move = ctx->listoflegalmoves[0];
+			result.score = BELOWWORST;
+			result.depth = 0;
+			result.complete = 0;
+			if (probeBook(ctx, result.key, &result) == 1)
+			{
+				stats->bookmoves++;
+			}
+			else
+			{
+				ttgeneration++;
+				ageHistory(ctx);
+				memset(ctx->killermoves, 0, sizeof(ctx->killermoves));
+				ctx->movetime = sidetime[whichplayer];
+				ctx->maxsearchdepth = sidedepth[whichplayer];
+				ctx->searchstart = chrono::steady_clock::now();
+				ctx->nodecount = 0;
+				ctx->searchaborted = 0;
+				memset(&ctx->stats, 0, sizeof(ctx->stats));
+				searchMoves(pos, ctx, whichplayer, &result, 1);
+				stats->searchedmoves++;
+				stats->nodes += ctx->nodecount;
+				addSearchStats(&stats->search, &ctx->stats);
+				stats->searchmicroseconds += chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - ctx->searchstart).count();
+			}
+			movecounter = findListedMove(ctx, &result);
+		}
+		playListedMove(pos, ctx, movecounter);
+		if (checkGameOver(pos) == 1)
+		{//it hit the death star.
+			stats->plies += ply + 1;
+			return whichplayer;
+		}
+		whichplayer = 1 - whichplayer;
+	}
+	stats->plies += MAXGAMEPLIES;
+	return -1;
+}
+
+void selfPlayWorker(SelfPlayStats* stats)
+{//play games until there are none left.
+	Position position = {};
+	SearchContext context = {};
+	for (int gamenum = nextselfplaygame++; gamenum < selfplaygames; gamenum = nextselfplaygame++)
+	{
+		long long plies = stats->plies;
+		int winner = selfPlayGame(&position, &context, gamenum, stats);
+		if (winner == -1)
+		{
+			stats->draws++;
+		}
+		else
+		{
+			stats->wins[winner]++;
+			if (winner == gamenum % 2)
+			{
+				stats->firstmoverwins++;
+			}
+		}
+		lock_guard<mutex> guard(selfplaylock);
+		cout << "game " << gamenum + 1 << ":  " << (winner == -1 ? "draw" : (winner == 1 ? "computer side won" : "human side won")) 
+			<< " in " << stats->plies - plies << " plies\n";
+	}
+}
+
+void runSelfPlay()
+{//play selfplaygames games on selfplayworkers threads, then print what happened and how fast.
+	for (int side = 0; side < 2; side++)
+	{
+		if (sidetime[side] < 0)
+		{
+			sidetime[side] = movetime;
+		}
+		if (sidedepth[side] < 0)
+		{
+			sidedepth[side] = maxsearchdepth;
+		}
+	}
+	cout << "self play:  " << selfplaygames << " games on " << selfplayworkers << " workers, " << openingplies << " random opening plies\n";
+	cout << "human side:  depth " << sidedepth[0] << ", " << sidetime[0] << " ms per move.  computer side:  depth " << sidedepth[1] << ", " 
+		<< sidetime[1] << " ms per move\n";
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	thread workers[MAXTHREADS];
+	SelfPlayStats workerstats[MAXTHREADS] = {};
+	nextselfplaygame = 0;
+	for (int workernum = 0; workernum < selfplayworkers; workernum++)
+	{
+		workers[workernum] = thread(selfPlayWorker, &workerstats[workernum]);
+	}
+	SelfPlayStats total = {};
+	for (int workernum = 0; workernum < selfplayworkers; workernum++)
+	{
+		workers[workernum].join();
+		total.wins[0] += workerstats[workernum].wins[0];
+		total.wins[1] += workerstats[workernum].wins[1];
+		total.draws += workerstats[workernum].draws;
+		total.firstmoverwins += workerstats[workernum].firstmoverwins;
+		total.plies += workerstats[workernum].plies;
+		total.searchedmoves += workerstats[workernum].searchedmoves;
+		total.bookmoves += workerstats[workernum].bookmoves;
+		total.nodes += workerstats[workernum].nodes;
+		total.searchmicroseconds += workerstats[workernum].searchmicroseconds;
+		addSearchStats(&total.search, &workerstats[workernum].search);
+	}
+	long long wallmicroseconds = chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - start).count();
+	
+	cout << "human side won " << total.wins[0] << ", computer side won " << total.wins[1] << ", draws " << total.draws 
+		<< ".  The side that went first won " << total.firstmoverwins << "\n";
+	cout << total.plies << " plies, " << total.searchedmoves << " searched moves, " << total.bookmoves << " book moves, " << total.nodes << " nodes in " << wallmicroseconds/1000 << " ms\n";
+	cout << "nodes per second per worker " << (long long)(total.nodes*1000000.0/max(total.searchmicroseconds, 1LL))
+		<< ", all workers " << (long long)(total.nodes*1000000.0/max(wallmicroseconds, 1LL)) << "\n";
+	cout << "average move latency " << total.searchmicroseconds/1000.0/max(total.searchedmoves, 1LL) << " ms\n";
+	cout << "first move cutoffs " << 100.0*total.search.firstmovecutoffs/max(total.search.betacutoffs, 1LL) << "%, transposition table hits " 
+		<< 100.0*total.search.tthits/max(total.search.ttprobes, 1LL) << "%, quiescence nodes " 
+		<< 100.0*total.search.quiescencenodes/max(total.nodes, 1LL) << "%, tablebase hits " << total.search.tbhits << "\n";
+}
+
+int playMoveString(Position* pos, SearchContext* ctx, int whichplayer, const char* text)
+{//make a move written the way the human enters them (B3C4) for whichplayer, the way a real move is made.  Returns 0 if it isn't legal.
+	ctx->movenum[0] = 0;
+	if (whichplayer == 1)
+	{
+		findComputerMoves(pos, ctx, 0);
+	}
+	else
+	{
+		findHumanMoves(pos, ctx, 0);
+	}
+	for (int movecounter = 0; movecounter < ctx->movenum[0] && strlen(text) >= 4; movecounter++)
+	{
+		Move move = ctx->listoflegalmoves[movecounter];
+		if (moveFrom(move) % XWIDTH == text[0] - 'A' && moveFrom(move) / XWIDTH == YWIDTH - (text[1] - '0')
+			&& moveTo(move) % XWIDTH == text[2] - 'A' && moveTo(move) / XWIDTH == YWIDTH - (text[3] - '0'))
+		{
+			playListedMove(pos, ctx, movecounter);
+			return 1;
+		}
+	}
+	return 0;
+}
+
+long long perft(Position* pos, SearchContext* ctx, int curdepth, int depth, int whichplayer)
+{//count the positions depth plies from the root, making and unmaking every move the way negamax does.  A game over has nothing below it.
+	if (curdepth >= depth)
+	{
+		return 1;
+	}
+	if (checkGameOver(pos) == 1)
+	{
+		return 0;
+	}
+	ctx->movenum[curdepth] = 0;
+	if (whichplayer == 1)
+	{
+		findComputerMoves(pos, ctx, curdepth);
+	}
+	else
+	{
+		findHumanMoves(pos, ctx, curdepth);
+	}
+	long long nodes = 0;
+	if (curdepth + 1 == depth)
+	{//the positions after each move are the leaves:  No need to make the moves to count them.
+		nodes = ctx->movenum[curdepth];
+	}
+	else
+	{
+		for (int movecounter = LISTSIZE*curdepth; movecounter < LISTSIZE*curdepth + ctx->movenum[curdepth]; movecounter++)
+		{
+			ctx->movestack[curdepth] = ctx->listoflegalmoves[movecounter];
+			movePiece(pos, ctx, curdepth);
+			nodes += perft(pos, ctx, curdepth + 1, depth, 1 - whichplayer);
+			resetPiecePosition(pos, ctx, curdepth);
+		}
+	}
+	return nodes;
+}
+
+void perftWorker(const Position* root, int whichplayer, int depth, const Move* rootmoves, int numofrootmoves, long long* counts)
+{//a perft thread:  take first moves until there are none left, and count the positions under each from this thread's own copy.
+	SearchContext context = {};
+	SearchContext* ctx = &context;
+	int curdepth = 0;
+	for (int movenumber = nextperftmove++; movenumber < numofrootmoves; movenumber = nextperftmove++)
+	{
+		Position position = *root;
+		Position* pos = &position;
+		ctx->movestack[curdepth] = rootmoves[movenumber];
+		movePiece(pos, ctx, curdepth);
+		counts[movenumber] = perft(pos, ctx, curdepth + 1, depth, 1 - whichplayer);
+	}
+}
+
+long long countPerft(Position* pos, SearchContext* ctx, int whichplayer, int depth, Move* rootmoves, long long* counts, int* numofrootmoves)
+{//count the positions depth plies from pos, with whichplayer to move, split over numofthreads threads by first move.  Leaves each first
+	//move in rootmoves and the count under it in counts, for -divide.
+	ctx->movenum[0] = 0;
+	if (whichplayer == 1)
+	{
+		findComputerMoves(pos, ctx, 0);
+	}
+	else
+	{
+		findHumanMoves(pos, ctx, 0);
+	}
+	*numofrootmoves = ctx->movenum[0];
+	if (checkGameOver(pos) == 1)
+	{
+		*numofrootmoves = 0;
+	}
+	for (int movenumber = 0; movenumber < *numofrootmoves; movenumber++)
+	{
+		rootmoves[movenumber] = ctx->listoflegalmoves[movenumber];
+		counts[movenumber] = 1;//depth 1:  each first move is a leaf
+	}
+	if (depth > 1)
+	{
+		nextperftmove = 0;
+		thread perftthreads[MAXTHREADS];
+		for (int threadnum = 1; threadnum < numofthreads; threadnum++)
+		{
+			perftthreads[threadnum] = thread(perftWorker, pos, whichplayer, depth, rootmoves, *numofrootmoves, counts);
+		}
+		perftWorker(pos, whichplayer, depth, rootmoves, *numofrootmoves, counts);
+		for (int threadnum = 1; threadnum < numofthreads; threadnum++)
+		{
+			perftthreads[threadnum].join();
+		}
+	}
+	
+	long long nodes = 0;
+	for (int movenumber = 0; movenumber < *numofrootmoves; movenumber++)
+	{
+		nodes += counts[movenumber];
+	}
+	return nodes;
+}
+
+void runPerft(Position* pos, SearchContext* ctx, int whichplayer)
+{//count the positions at each depth up to perftdepth from pos, with whichplayer to move, and time them.
+	printBoard(pos);
+	char notation[NOTATIONSIZE];
+	writeNotation(pos, whichplayer, notation);
+	cout << "position " << notation << "\n";
+	for (int depth = 1; depth <= perftdepth; depth++)
+	{
+		chrono::steady_clock::time_point start = chrono::steady_clock::now();
+		Move rootmoves[LISTSIZE];//each first move.  The list at depth 0 gets written over by the threads.
+		long long counts[LISTSIZE];
+		int numofrootmoves;
+		long long nodes = countPerft(pos, ctx, whichplayer, depth, rootmoves, counts, &numofrootmoves);
+		long long microseconds = chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - start).count();
+		if (perftdivide == 1 && depth == perftdepth)
+		{
+			for (int movenumber = 0; movenumber < numofrootmoves; movenumber++)
+			{
+				Move move = rootmoves[movenumber];
+				cout << char(moveFrom(move) % XWIDTH + 'A') << char(YWIDTH - moveFrom(move) / XWIDTH + '0') << char(moveTo(move) % XWIDTH + 'A') 
+					<< char(YWIDTH - moveTo(move) / XWIDTH + '0') << ":  " << counts[movenumber] << "\n";
+			}
+		}
+		cout << "perft " << depth << ":  " << nodes << " nodes in " << microseconds/1000.0 << " ms, " 
+			<< (long long)(nodes*1000000.0/max(microseconds, 1LL)) << " nodes per second\n";
+	}
+}
+
+int runPerftSuite()
+{//count each suite position at each depth it has a count for, and say which match.  A wrong count means the move generation, make/unmake
+	//or the horizontal rule changed.
+	int failures = 0;
+	int checks = 0;
+	for (int casenum = 0; casenum < NUMOFPERFTCASES; casenum++)
+	{
+		Position position = {};
+		SearchContext context = {};
+		int whichplayer = 0;
+		if (readNotation(&position, PERFTSUITE[casenum].notation, &whichplayer) == 0)
+		{
+			cout << "not a position:  " << PERFTSUITE[casenum].notation << "\n";
+			failures++;
+			continue;
+		}
+		cout << "position " << PERFTSUITE[casenum].notation << "\n";
+		for (int depth = 1; depth <= PERFTSUITEMAXDEPTH && PERFTSUITE[casenum].counts[depth - 1] > 0; depth++)
+		{
+			Move rootmoves[LISTSIZE];
+			long long counts[LISTSIZE];
+			int numofrootmoves;
+			long long nodes = countPerft(&position, &context, whichplayer, depth, rootmoves, counts, &numofrootmoves);
+			long long expected = PERFTSUITE[casenum].counts[depth - 1];
+			checks++;
+			if (nodes == expected)
+			{
+				cout << "perft " << depth << ":  " << nodes << " pass\n";
+			}
+			else
+			{
+				cout << "perft " << depth << ":  " << nodes << " FAIL, expected " << expected << "\n";
+				failures++;
+			}
+		}
+	}
+	cout << checks - failures << " of " << checks << " counts passed\n";
+	return failures;
+}
+
+void runBench()
+{//search each bench position to benchdepth with one thread, starting from an empty transposition table and history each time, and add
+	//up the nodes.  The same search always gives the same total, so it's a signature:  A change that shouldn't change the search has to
+	//give the same number, and the nodes per second show if it got slower.  Only the searches are timed.
+	Position position = {};
+	SearchContext context = {};
+	Position* pos = &position;
+	SearchContext* ctx = &context;
+	ctx->movetime = 1 << 30;//the depth decides how long it takes
+	ctx->maxsearchdepth = benchdepth;
+	long long totalnodes = 0;
+	long long totalmicroseconds = 0;
+	for (int positionnum = 0; positionnum < NUMOFBENCHPOSITIONS; positionnum++)
+	{
+		int whichplayer;
+		readNotation(pos, BENCHPOSITIONS[positionnum], &whichplayer);
+		clearTransposition();
+		memset(ctx->historytable, 0, sizeof(ctx->historytable));
+		memset(ctx->killermoves, 0, sizeof(ctx->killermoves));
+		ctx->movenum[0] = 0;
+		if (whichplayer == 1)
+		{
+			findComputerMoves(pos, ctx, 0);
+		}
+		else
+		{
+			findHumanMoves(pos, ctx, 0);
+		}
+		SearchResult result;
+		result.key = positionKey(pos, whichplayer);
+		result.move = ctx->listoflegalmoves[0];
+		result.score = BELOWWORST;
+		result.depth = 0;
+		result.complete = 0;
+		ctx->nodecount = 0;
+		ctx->searchaborted = 0;
+		memset(&ctx->stats, 0, sizeof(ctx->stats));
+		ctx->searchstart = chrono::steady_clock::now();
+		searchMoves(pos, ctx, whichplayer, &result, 1);
+		totalmicroseconds += chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - ctx->searchstart).count();
+		totalnodes += ctx->nodecount;
+		char movetext[5];
+		moveText(result.move, movetext);
+		cout << "position " << positionnum + 1 << ":  " << movetext << ", score " << result.score << ", " << ctx->nodecount << " nodes\n";
+	}
+	cout << "bench depth " << benchdepth << ":  " << totalnodes << " nodes in " << totalmicroseconds/1000 << " ms, " 
+		<< (long long)(totalnodes*1000000.0/max(totalmicroseconds, 1LL)) << " nodes per second\n";
+}
+
+template <typename Pass> void timeKernel(const char* name, Pass pass)
+{//pass makes one pass over the corpus and returns how many calls it made.  Each sample repeats it until it has made about
+	//MICROBENCHSAMPLEOPS calls.  Prints the mean time per call over the samples, their standard deviation and the fastest one.
+	long long passops = max(pass(), 1LL);//the first pass also warms up the caches and the branch predictor
+	long long passes = max(MICROBENCHSAMPLEOPS/passops, 1LL);
+	double samples[MICROBENCHSAMPLES];
+	double mean = 0;
+	double fastest = 1e30;
+	for (int samplenum = 0; samplenum < MICROBENCHSAMPLES; samplenum++)
+	{
+		chrono::steady_clock::time_point start = chrono::steady_clock::now();
+		for (long long passnum = 0; passnum < passes; passnum++)
+		{
+			pass();
+		}
+		samples[samplenum] = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count()/(passes*passops);
+		mean += samples[samplenum]/MICROBENCHSAMPLES;
+		fastest = min(fastest, samples[samplenum]);
+	}
+	double variance = 0;
+	for (int samplenum = 0; samplenum < MICROBENCHSAMPLES; samplenum++)
+	{
+		variance += (samples[samplenum] - mean)*(samples[samplenum] - mean)/(MICROBENCHSAMPLES - 1);
+	}
+	printf("%-34s %8.2f ns/op   stddev %6.2f   min %8.2f   %lld ops a sample\n", name, mean, sqrt(variance), fastest, passes*passops);
+}
+
+void runMicrobench()
+{//time the kernels the search spends its time in, one at a time, over a corpus of the bench positions and every position one or two
+	//plies after them.  Each kernel is called the way the search calls it.  The corpus positions are changed and put back, never copied,
+	//so the times don't include copying.
+	Position* corpus = new Position[MICROBENCHCORPUSSIZE];
+	int* corpusplayers = new int[MICROBENCHCORPUSSIZE];
+	Move* corpusmoves = new Move[MICROBENCHCORPUSSIZE*LISTSIZE];//each position's legal moves, LISTSIZE apart
+	int* corpusmovenums = new int[MICROBENCHCORPUSSIZE];
+	SearchContext* ctx = new SearchContext();
+	int corpussize = 0;
+	for (int positionnum = 0; positionnum < NUMOFBENCHPOSITIONS && corpussize < MICROBENCHCORPUSSIZE; positionnum++)
+	{
+		readNotation(&corpus[corpussize], BENCHPOSITIONS[positionnum], &corpusplayers[corpussize]);
+		int first = corpussize++;
+		int last = first + 1;//positions first to last - 1 get their children added, for two plies
+		for (int ply = 0; ply < 2; ply++)
+		{
+			for (int parent = first; parent < last; parent++)
+			{
+				ctx->movenum[0] = 0;
+				if (corpusplayers[parent] == 1)
+				{
+					findComputerMoves(&corpus[parent], ctx, 0);
+				}
+				else
+				{
+					findHumanMoves(&corpus[parent], ctx, 0);
+				}
+				for (int movecounter = 0; movecounter < ctx->movenum[0] && corpussize < MICROBENCHCORPUSSIZE; movecounter++)
+				{
+					corpus[corpussize] = corpus[parent];
+					ctx->movestack[0] = ctx->listoflegalmoves[movecounter];
+					movePiece(&corpus[corpussize], ctx, 0);
+					corpusplayers[corpussize] = 1 - corpusplayers[parent];
+					if (checkGameOver(&corpus[corpussize]) == 0)
+					{
+						corpussize++;
+					}
+				}
+			}
+			first = last;
+			last = corpussize;
+		}
+	}
+	long long numofmoves = 0;
+	for (int positionnum = 0; positionnum < corpussize; positionnum++)
+	{
+		ctx->movenum[0] = 0;
+		if (corpusplayers[positionnum] == 1)
+		{
+			findComputerMoves(&corpus[positionnum], ctx, 0);
+		}
+		else
+		{
+			findHumanMoves(&corpus[positionnum], ctx, 0);
+		}
+		corpusmovenums[positionnum] = ctx->movenum[0];
+		memcpy(&corpusmoves[positionnum*LISTSIZE], ctx->listoflegalmoves, ctx->movenum[0]*sizeof(Move));
+		numofmoves += ctx->movenum[0];
+	}
+	printf("%d positions, %lld moves, %d samples per kernel\n", corpussize, numofmoves, MICROBENCHSAMPLES);
+	
+	timeKernel("legalXWing", [&]()
+	{//every x wing on the board, both sides'
+		long long ops = 0;
+		for (int positionnum = 0; positionnum < corpussize; positionnum++)
+		{
+			for (int piecenum = 0; piecenum < NUMOFPIECES*4; piecenum += (piecenum % (NUMOFPIECES*2) == NUMOFPIECES - 1) ? NUMOFPIECES + 1 : 1)
+			{
+				if (corpus[positionnum].capturedpieces[piecenum] == 0)
+				{
+					ctx->movenum[0] = 0;
+					legalXWing(&corpus[positionnum], ctx, piecenum, 0, 0);
+					microbenchsink += ctx->movenum[0];
+					ops++;
+				}
+			}
+		}
+		return ops;
+	});
+	timeKernel("legalTieFighter", [&]()
+	{//every tie fighter on the board, both sides'
+		long long ops = 0;
+		for (int positionnum = 0; positionnum < corpussize; positionnum++)
+		{
+			for (int piecenum = NUMOFPIECES; piecenum < NUMOFPIECES*4; piecenum += (piecenum % (NUMOFPIECES*2) == NUMOFPIECES*2 - 1) ? NUMOFPIECES + 1 : 1)
+			{
+				if (corpus[positionnum].capturedpieces[piecenum] == 0)
+				{
+					ctx->movenum[0] = 0;
+					legalTieFighter(&corpus[positionnum], ctx, piecenum, 0, 0);
+					microbenchsink += ctx->movenum[0];
+					ops++;
+				}
+			}
+		}
+		return ops;
+	});
+	timeKernel("findHumanMoves", [&]()
+	{
+		for (int positionnum = 0; positionnum < corpussize; positionnum++)
+		{
+			ctx->movenum[0] = 0;
+			findHumanMoves(&corpus[positionnum], ctx, 0);
+			microbenchsink += ctx->movenum[0];
+		}
+		return (long long)corpussize;
+	});
+	timeKernel("findComputerMoves", [&]()
+	{
+		for (int positionnum = 0; positionnum < corpussize; positionnum++)
+		{
+			ctx->movenum[0] = 0;
+			findComputerMoves(&corpus[positionnum], ctx, 0);
+			microbenchsink += ctx->movenum[0];
+		}
+		return (long long)corpussize;
+	});
+	timeKernel("movePiece + resetPiecePosition", [&]()
+	{//every legal move of the side to move, made and unmade
+		for (int positionnum = 0; positionnum < corpussize; positionnum++)
+		{
+			for (int movecounter = 0; movecounter < corpusmovenums[positionnum]; movecounter++)
+			{
+				ctx->movestack[1] = corpusmoves[positionnum*LISTSIZE + movecounter];
+				movePiece(&corpus[positionnum], ctx, 1);
+				microbenchsink += corpus[positionnum].evaluation;
+				resetPiecePosition(&corpus[positionnum], ctx, 1);
+			}
+		}
+		return numofmoves;
+	});
+	timeKernel("checkPieceRemoved", [&]()
+	{//every legal move of the side to move.  Captures are put back by hand, the way resetPiecePosition does it.
+		for (int positionnum = 0; positionnum < corpussize; positionnum++)
+		{
+			Position* pos = &corpus[positionnum];
+			for (int movecounter = 0; movecounter < corpusmovenums[positionnum]; movecounter++)
+			{
+				ctx->movestack[1] = corpusmoves[positionnum*LISTSIZE + movecounter];
+				if (checkPieceRemoved(pos, ctx, 1) == 0)
+				{
+					int captured = ctx->undostack[1].captured;
+					int to = moveTo(ctx->movestack[1]);
+					pos->capturedpieces[captured] = 0;
+					pos->pieceboards[captured/NUMOFPIECES] |= 1ULL << to;
+					pos->zobristkey ^= zobrist.pieces[captured/NUMOFPIECES][to];
+					pos->evaluation -= CAPTUREVALUES[captured/NUMOFPIECES];
+					microbenchsink++;
+				}
+			}
+		}
+		return numofmoves;
+	});
+	timeKernel("evaluate", [&]()
+	{
+		for (int positionnum = 0; positionnum < corpussize; positionnum++)
+		{
+			microbenchsink += evaluate(&corpus[positionnum], 0);
+		}
+		return (long long)corpussize;
+	});
+	printf("checksum %lld\n", microbenchsink);
+	delete ctx;
+	delete[] corpusmovenums;
+	delete[] corpusmoves;
+	delete[] corpusplayers;
+	delete[] corpus;
+}
+
+long long tablebaseSize(const int counts[4])
+{//the four combinations, times the side to move, times whether each side moved a tie fighter sideways last turn.
+	long long size = 8;
+	for (int piecetype = 0; piecetype < 4; piecetype++)
+	{
+		size *= tbindexing.binomial[TBSQUARES][counts[piecetype]];
+	}
+	return size;
+}
+
+long long tablebaseIndex(Position* pos, int whichplayer)
+{//the place of the position in the table for its piece counts.  Only a horizontal value of 2 stops a sideways move, so 1 and 0 are the same.
+	long long index = 0;
+	for (int piecetype = 0; piecetype < 4; piecetype++)
+	{
+		long long combination = 0;
+		int piececount = 0;
+		for (bitboard pieces = pos->pieceboards[piecetype]; pieces != 0; pieces &= pieces - 1)
+		{//lowest square first
+			int place = tbindexing.squareplace[__builtin_ctzll(pieces)];
+			if (place < 0)
+			{//on a death star:  the game is over.
+				return -1;
+			}
+			piececount++;
+			combination += tbindexing.binomial[place][piececount];
+		}
+		index = index*tbindexing.binomial[TBSQUARES][piececount] + combination;
+	}
+	return index*8 + whichplayer*4 + (pos->horizontalcomputer == 2)*2 + (pos->horizontalhuman == 2);
+}
+
+int setupTablebasePosition(Position* pos, const int counts[4], long long index, int* whichplayer)
+{//put the pieces where the index says, the same way setup does.  Some indexes have two types on one square:  Those aren't positions.
+	pos->horizontalhuman = (index & 1)*2;
+	pos->horizontalcomputer = ((index >> 1) & 1)*2;
+	*whichplayer = (index >> 2) & 1;
+	index = index/8;
+	bitboard occupied = 0;
+	for (int piecetype = 3; piecetype >= 0; piecetype--)
+	{//the last type is the lowest part of the index
+		long long combinations = tbindexing.binomial[TBSQUARES][counts[piecetype]];
+		long long combination = index % combinations;
+		index = index/combinations;
+		int place = TBSQUARES - 1;
+		for (int piecenum = piecetype*NUMOFPIECES + NUMOFPIECES - 1; piecenum >= piecetype*NUMOFPIECES; piecenum--)
+		{
+			int pieceorder = piecenum - piecetype*NUMOFPIECES + 1;//1 for the lowest square
+			if (pieceorder > counts[piecetype])
+			{
+				pos->capturedpieces[piecenum] = 1;
+				continue;
+			}
+			while (tbindexing.binomial[place][pieceorder] > combination)
+			{//the highest place whose coefficient fits
+				place--;
+			}
+			combination -= tbindexing.binomial[place][pieceorder];
+			int square = tbindexing.placesquare[place];
+			if ((occupied >> square) & 1)
+			{
+				return 0;
+			}
+			occupied |= 1ULL << square;
+			pos->capturedpieces[piecenum] = 0;
+			pos->piecepositions[piecenum*2] = square / XWIDTH;
+			pos->piecepositions[piecenum*2+1] = square % XWIDTH;
+		}
+	}
+	setupBitboards(pos);
+	return 1;
+}
+
+int probeTablebase(Position* pos, int whichplayer, int curdepth, int* score)
+{//look the position up, and score it the way negamax scores a game over:  The sooner the win, the better.  A draw is 0.
+	int counts[4];
+	int totalpieces = 0;
+	for (int piecetype = 0; piecetype < 4; piecetype++)
+	{
+		counts[piecetype] = __builtin_popcountll(pos->pieceboards[piecetype]);
+		totalpieces += counts[piecetype];
+	}
+	if (totalpieces > tbpieces || counts[0] > NUMOFPIECES || counts[1] > NUMOFPIECES || counts[2] > NUMOFPIECES || counts[3] > NUMOFPIECES)
+	{
+		return 0;
+	}
+	const unsigned char* values = tablebases[counts[0]][counts[1]][counts[2]][counts[3]];
+	long long index = tablebaseIndex(pos, whichplayer);
+	if (values == NULL || index < 0)
+	{
+		return 0;
+	}
+	int value = values[index];
+	if (value == 0)
+	{
+		*score = 0;
+	}
+	else if (value >= TBLOSS)
+	{//lost:  the game ends that many plies from here.  Kept short of WINNINGSCORE's edge, so it still reads as a game over.
+		*score = BELOWWORST + 1 + min(curdepth + value - TBLOSS, ABOVEBEST - WINNINGSCORE - 2);
+	}
+	else
+	{
+		*score = -(BELOWWORST + 1 + min(curdepth + value, ABOVEBEST - WINNINGSCORE - 2));
+	}
+	return 1;
+}
+
+int solveTablebasePosition(Position* pos, SearchContext* ctx, int whichplayer, const unsigned char* values, int distance)
+{//one step of retrograde analysis.  The position is won in distance plies if a move reaches a position lost in distance - 1, and lost in
+	//distance plies if every move reaches a position won in less.  values is this table as it was before this distance started, so the
+	//threads all see the same thing.  Captures reach smaller tables, which are already solved.
+	int curdepth = 0;
+	ctx->movenum[curdepth] = 0;
+	if (whichplayer == 1)
+	{
+		findComputerMoves(pos, ctx, curdepth);
+	}
+	else
+	{
+		findHumanMoves(pos, ctx, curdepth);
+	}
+	if (ctx->movenum[curdepth] == 0)
+	{//no moves:  lost right here.
+		return distance == 0 ? TBLOSS : 0;
+	}
+	int allwon = 1;//every move so far reaches a position the other side wins
+	for (int movecounter = 0; movecounter < ctx->movenum[curdepth]; movecounter++)
+	{
+		Move move = ctx->listoflegalmoves[movecounter];
+		int childvalue = TBLOSS;//hitting the death star:  the other side has lost
+		if ((move & MOVEDEATHSTAR) == 0)
+		{
+			ctx->movestack[curdepth] = move;
+			movePiece(pos, ctx, curdepth);
+			const unsigned char* childvalues = values;
+			if (move & MOVECAPTURE)
+			{
+				childvalues = tablebases[__builtin_popcountll(pos->pieceboards[0])][__builtin_popcountll(pos->pieceboards[1])]
+					[__builtin_popcountll(pos->pieceboards[2])][__builtin_popcountll(pos->pieceboards[3])];
+			}
+			childvalue = childvalues[tablebaseIndex(pos, 1 - whichplayer)];
+			resetPiecePosition(pos, ctx, curdepth);
+		}
+		if (childvalue >= TBLOSS && childvalue - TBLOSS < distance)
+		{
+			return distance;
+		}
+		if (childvalue == 0 || childvalue >= TBLOSS || childvalue >= distance)
+		{//a draw, a loss, or a win that isn't decided yet
+			allwon = 0;
+		}
+	}
+	return allwon == 1 ? TBLOSS + distance : 0;
+}
+
+void tablebaseWorker(const int* counts, unsigned char* values, const unsigned char* previous, int distance, long long* solved)
+{//a generator thread:  take chunks of positions until there are none left, and solve the ones that aren't solved yet.  Each thread only
+	//writes its own chunks of values.
+	Position position = {};
+	SearchContext context = {};
+	Position* pos = &position;
+	SearchContext* ctx = &context;
+	long long size = tablebaseSize(counts);
+	for (long long chunk = nexttbchunk.fetch_add(TBCHUNKSIZE); chunk < size; chunk = nexttbchunk.fetch_add(TBCHUNKSIZE))
+	{
+		for (long long index = chunk; index < min(chunk + TBCHUNKSIZE, size); index++)
+		{
+			int whichplayer = 0;
+			if (previous[index] != 0 || setupTablebasePosition(pos, counts, index, &whichplayer) == 0)
+			{
+				continue;
+			}
+			values[index] = solveTablebasePosition(pos, ctx, whichplayer, previous, distance);
+			*solved += values[index] != 0;
+		}
+	}
+}
+
+void generateTablebase(const int counts[4])
+{//solve every position with these pieces, one distance at a time, split over numofthreads threads.  Once a distance solves nothing new and
+	//the smaller tables can't decide anything later, whatever is left is a draw.
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	long long size = tablebaseSize(counts);
+	unsigned char* values = new unsigned char[size]();
+	unsigned char* previous = new unsigned char[size]();
+	long long wins = 0;
+	long long losses = 0;
+	int longest = 0;
+	int distance = 0;
+	for (; distance <= TBMAXDISTANCE; distance++)
+	{
+		long long solved[MAXTHREADS] = {};
+		nexttbchunk = 0;
+		thread tbthreads[MAXTHREADS];
+		for (int threadnum = 1; threadnum < numofthreads; threadnum++)
+		{
+			tbthreads[threadnum] = thread(tablebaseWorker, counts, values, previous, distance, &solved[threadnum]);
+		}
+		tablebaseWorker(counts, values, previous, distance, &solved[0]);
+		long long solvednow = 0;
+		for (int threadnum = 0; threadnum < numofthreads; threadnum++)
+		{
+			if (threadnum > 0)
+			{
+				tbthreads[threadnum].join();
+			}
+			solvednow += solved[threadnum];
+		}
+		memcpy(previous, values, size);
+		if (distance % 2 == 0)
+		{//the side to move loses at even distances, and wins at odd ones.
+			losses += solvednow;
+		}
+		else
+		{
+			wins += solvednow;
+		}
+		if (solvednow > 0)
+		{
+			longest = distance;
+		}
+		if (solvednow == 0 && distance > tbmaxdistance + 1)
+		{
+			break;
+		}
+	}
+	if (distance > TBMAXDISTANCE)
+	{
+		cout << "warning:  positions won or lost in more than " << TBMAXDISTANCE << " plies are left as draws\n";
+	}
+	
+	char filename[1024];
+	snprintf(filename, sizeof(filename), "%s/tb%d%d%d%d.bin", tbpath, counts[0], counts[1], counts[2], counts[3]);
+	char header[TBHEADERSIZE] = {'K', 'Z', 'T', 'B', (char)counts[0], (char)counts[1], (char)counts[2], (char)counts[3], (char)longest, (char)TBVERSION};
+	FILE* file = fopen(filename, "wb");
+	if (file == NULL || fwrite(header, 1, TBHEADERSIZE, file) != TBHEADERSIZE || fwrite(values, 1, size, file) != (size_t)size)
+	{
+		cout << "couldn't write " << filename << "\n";
+		exit(1);
+	}
+	fclose(file);
+	delete[] values;
+	delete[] previous;
+	
+	long long microseconds = chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - start).count();
+	cout << filename << ":  " << size << " positions, " << wins << " won, " << losses << " lost, longest " << longest 
+		<< " plies, " << microseconds/1000.0 << " ms\n";
+	loadTablebase(counts);
+}
+
+int loadTablebase(const int counts[4])
+{//map the table's file read only.  The pages are shared with every other process probing the same table, and only the ones probed get read.
+	//The header has the longest distance in the table, so the generator doesn't have to read it all.
+	char filename[1024];
+	snprintf(filename, sizeof(filename), "%s/tb%d%d%d%d.bin", tbpath, counts[0], counts[1], counts[2], counts[3]);
+	int file = open(filename, O_RDONLY);
+	if (file < 0)
+	{
+		return 0;
+	}
+	struct stat filestatus;
+	long long size = TBHEADERSIZE + tablebaseSize(counts);
+	void* mapped = MAP_FAILED;
+	if (fstat(file, &filestatus) == 0 && filestatus.st_size == size)
+	{
+		mapped = mmap(NULL, size, PROT_READ, MAP_SHARED, file, 0);
+	}
+	close(file);//the mapping stays
+	const unsigned char* header = (const unsigned char*)mapped;
+	if (mapped == MAP_FAILED || memcmp(header, "KZTB", 4) != 0 
+		|| header[4] != counts[0] || header[5] != counts[1] || header[6] != counts[2] || header[7] != counts[3] || header[9] != TBVERSION)
+	{
+		cout << filename << " isn't a tablebase for these pieces, or is from an older version\n";
+		if (mapped != MAP_FAILED)
+		{
+			munmap(mapped, size);
+		}
+		return 0;
+	}
+	tbmaxdistance = max(tbmaxdistance, (int)header[8]);
+	tablebases[counts[0]][counts[1]][counts[2]][counts[3]] = header + TBHEADERSIZE;
+	tbpieces = max(tbpieces, counts[0] + counts[1] + counts[2] + counts[3]);
+	return 1;
+}
+
+void loadTablebases()
+{//map every table in tbpath.  Missing ones are just not probed.
+	int counts[4];
+	for (counts[0] = 0; counts[0] <= NUMOFPIECES; counts[0]++)
+	{
+		for (counts[1] = 0; counts[1] <= NUMOFPIECES; counts[1]++)
+		{
+			for (counts[2] = 0; counts[2] <= NUMOFPIECES; counts[2]++)
+			{
+				for (counts[3] = 0; counts[3] <= NUMOFPIECES; counts[3]++)
+				{
+					if (counts[0] + counts[1] + counts[2] + counts[3] <= TBMAXPIECES)
+					{
+						loadTablebase(counts);
+					}
+				}
+			}
+		}
+	}
+}
+
+void runTablebaseGeneration()
+{//generate the tables with the fewest pieces first, since a capture in a bigger table leads to a smaller one.  Tables already on disk are kept.
+	mkdir(tbpath, 0755);
+	int counts[4];
+	for (int totalpieces = 1; totalpieces <= tbgenerate; totalpieces++)
+	{
+		for (counts[0] = 0; counts[0] <= min(totalpieces, NUMOFPIECES); counts[0]++)
+		{
+			for (counts[1] = 0; counts[1] <= min(totalpieces - counts[0], NUMOFPIECES); counts[1]++)
+			{
+				for (counts[2] = 0; counts[2] <= min(totalpieces - counts[0] - counts[1], NUMOFPIECES); counts[2]++)
+				{
+					counts[3] = totalpieces - counts[0] - counts[1] - counts[2];
+					if (counts[3] <= NUMOFPIECES && tablebases[counts[0]][counts[1]][counts[2]][counts[3]] == NULL)
+					{
+						generateTablebase(counts);
+					}
+				}
+			}
+		}
+	}
+}
+
+int probeBook(SearchContext* ctx, bitboard key, SearchResult* result)
+{//binary search the book for the position.  The list of moves at depth 0 has to be found already:  The book move has to be in it, in case
+	//another position has the same key.
+	if (book == NULL)
+	{
+		return 0;
+	}
+	const BookEntry* entry = lower_bound(book, book + numofbookentries, key, [](const BookEntry& bookentry, bitboard bookkey) { return bookentry.key < bookkey; });
+	if (entry == book + numofbookentries || entry->key != key)
+	{
+		return 0;
+	}
+	for (int movecounter = 0; movecounter < ctx->movenum[0]; movecounter++)
+	{
+		if ((ctx->listoflegalmoves[movecounter] & MOVESQUARES) == (entry->move & MOVESQUARES))
+		{
+			result->move = ctx->listoflegalmoves[movecounter];
+			result->score = entry->score;
+			result->depth = entry->depth;
+			result->complete = 1;
+			return 1;
+		}
+	}
+	return 0;
+}
+
+void addBookLines(Position* pos, SearchContext* ctx, int whichplayer, int bookside, int pliesleft, map<bitboard, BookEntry>* entries)
+{//search every position bookside can be in during the next pliesleft plies, if it plays the book's moves and the other side plays anything.
+	if (pliesleft == 0 || checkGameOver(pos) == 1)
+	{
+		return;
+	}
+	ctx->movenum[0] = 0;
+	if (whichplayer == 1)
+	{
+		findComputerMoves(pos, ctx, 0);
+	}
+	else
+	{
+		findHumanMoves(pos, ctx, 0);
+	}
+	int numofmoves = ctx->movenum[0];
+	Move moves[LISTSIZE];//the moves to follow.  The lines below write over the list at depth 0.
+	memcpy(moves, ctx->listoflegalmoves, numofmoves*sizeof(Move));
+	if (whichplayer == bookside && numofmoves > 0)
+	{
+		bitboard key = positionKey(pos, whichplayer);
+		if (entries->count(key) == 0)
+		{//not reached by another move order yet:  search it like self play does, only deeper.
+			SearchResult result;
+			result.key = key;
+			result.move = ctx->listoflegalmoves[0];
+			result.score = BELOWWORST;
+			result.depth = 0;
+			result.complete = 0;
+			ttgeneration++;
+			ageHistory(ctx);
+			memset(ctx->killermoves, 0, sizeof(ctx->killermoves));
+			ctx->searchstart = chrono::steady_clock::now();
+			ctx->nodecount = 0;
+			ctx->searchaborted = 0;
+			memset(&ctx->stats, 0, sizeof(ctx->stats));
+			searchMoves(pos, ctx, whichplayer, &result, 1);
+			BookEntry entry = {key, result.move, (short)result.score, (short)result.depth};
+			(*entries)[key] = entry;
+			if (entries->size() % 100 == 0)
+			{
+				cout << entries->size() << " book positions searched\n";
+			}
+		}
+		moves[0] = (*entries)[key].move;//only the book's move is played from here
+		numofmoves = 1;
+	}
+	for (int movecounter = 0; movecounter < numofmoves; movecounter++)
+	{
+		Position child = *pos;
+		ctx->movestack[0] = moves[movecounter];
+		movePiece(&child, ctx, 0);
+		addBookLines(&child, ctx, 1 - whichplayer, bookside, pliesleft - 1, entries);
+	}
+}
+
+void runBookGeneration()
+{//build the book for both sides, whoever goes first, and write it sorted by key.  Tablebases that are loaded are used by the search.
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	SearchContext context = {};
+	SearchContext* ctx = &context;
+	ctx->movetime = 1 << 30;//the depth decides how long it takes
+	ctx->maxsearchdepth = bookdepth;
+	map<bitboard, BookEntry> entries;
+	for (int bookside = 0; bookside < 2; bookside++)
+	{
+		for (int firstplayer = 0; firstplayer < 2; firstplayer++)
+		{
+			Position position = {};
+			setup(&position);
+			position.horizontalhuman = 0;
+			position.horizontalcomputer = 0;
+			addBookLines(&position, ctx, firstplayer, bookside, bookplies, &entries);
+		}
+	}
 	
-	char xold = bestpiecetomovex + 'A';//just like with int to char, need to displace by ASCII text
-	char xoldinv = 'G' - bestpiecetomovex;
-    char yold = (YWIDTH - bestpiecetomovey) + '0';// to get inverse, a = width - b
-	char yoldinv = '8' - (YWIDTH - bestpiecetomovey);
-    char xnew = bestpiecenewx + 'A';
-	char xnewinv = 'G' - bestpiecenewx;
-    char ynew = (YWIDTH - bestpiecenewy) + '0';
-	char ynewinv = '8' - (YWIDTH - bestpiecenewy);
-    //cout << " " << xold << "" << yold << "" << xnew << "" << ynew;//Debug, to see moves made
+	FILE* file = fopen(bookpath, "wb");
+	char header[BOOKHEADERSIZE] = {'K', 'Z', 'B', 'K'};
+	if (file == NULL || fwrite(header, 1, BOOKHEADERSIZE, file) != BOOKHEADERSIZE)
+	{
+		cout << "couldn't write " << bookpath << "\n";
+		exit(1);
+	}
+	for (const auto& keyentry : entries)
+	{//a map goes through its keys in order
+		fwrite(&keyentry.second, sizeof(BookEntry), 1, file);
+	}
+	if (fclose(file) != 0)
+	{
+		cout << "couldn't write " << bookpath << "\n";
+		exit(1);
+	}
+	long long microseconds = chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - start).count();
+	cout << bookpath << ":  " << entries.size() << " positions searched to depth " << bookdepth << " in " << microseconds/1000000.0 << " s\n";
+}
+
+void loadBook()
+{//map the book read only, if there is one.
+	int file = open(bookpath, O_RDONLY);
+	if (file < 0)
+	{
+		return;
+	}
+	struct stat filestatus;
+	void* mapped = MAP_FAILED;
+	if (fstat(file, &filestatus) == 0 && filestatus.st_size >= BOOKHEADERSIZE && (filestatus.st_size - BOOKHEADERSIZE) % sizeof(BookEntry) == 0)
+	{
+		mapped = mmap(NULL, filestatus.st_size, PROT_READ, MAP_SHARED, file, 0);
+	}
+	close(file);
+	if (mapped == MAP_FAILED || memcmp(mapped, "KZBK", 4) != 0)
+	{
+		cout << bookpath << " isn't an opening book\n";
+		if (mapped != MAP_FAILED)
+		{
+			munmap(mapped, filestatus.st_size);
+		}
+		return;
+	}
+	book = (const BookEntry*)((const char*)mapped + BOOKHEADERSIZE);
+	numofbookentries = (filestatus.st_size - BOOKHEADERSIZE)/sizeof(BookEntry);
+}
+
+void moveText(Move move, char* text)
+{//write the move the way the human enters them, B3C4.  text needs room for 5 characters.
+	text[0] = moveFrom(move) % XWIDTH + 'A';
+	text[1] = (YWIDTH - moveFrom(move) / XWIDTH) + '0';
+	text[2] = moveTo(move) % XWIDTH + 'A';
+	text[3] = (YWIDTH - moveTo(move) / XWIDTH) + '0';
+	text[4] = '\0';
+}
+
+int writeScore(int score, char* text, int size)
+{//"score" and the score, for the protocol and the analysis.  A decided game's score is the plies to the win or loss.  Returns the length.
+	if (score > WINNINGSCORE)
+	{
+		return snprintf(text, size, "score win %d", ABOVEBEST - 1 - score);
+	}
+	else if (score < -WINNINGSCORE)
+	{
+		return snprintf(text, size, "score loss %d", score - BELOWWORST - 1);
+	}
+	return snprintf(text, size, "score %d", score);
+}
+
+int writePrincipalVariation(Position* pos, SearchContext* pvctx, int whichplayer, const SearchResult* result, char* text, int size)
+{//" pv" and the moves:  the result's move, then the transposition table's best move in each position after it, for as long as they are
+	//legal and the depth lasts.  pvctx's list at depth 0 gets written over.  Returns the length.
+	Position position = *pos;
+	int player = whichplayer;
+	Move move = result->move;
+	int length = snprintf(text, size, " pv");
+	for (int ply = 0; ply < result->depth; ply++)
+	{
+		pvctx->movenum[0] = 0;
+		if (player == 1)
+		{
+			findComputerMoves(&position, pvctx, 0);
+		}
+		else
+		{
+			findHumanMoves(&position, pvctx, 0);
+		}
+		int movecounter = 0;
+		while (movecounter < pvctx->movenum[0] && (pvctx->listoflegalmoves[movecounter] & MOVESQUARES) != (move & MOVESQUARES))
+		{
+			movecounter++;
+		}
+		if (movecounter == pvctx->movenum[0])
+		{//another position with the same key stored this one.
+			break;
+		}
+		char movetext[5];
+		moveText(move, movetext);
+		length += snprintf(text + length, max(size - length, 0), " %s", movetext);
+		playListedMove(&position, pvctx, movecounter);
+		player = 1 - player;
+		int remainingdepth, score, bound, bestfrom, bestto;
+		if (checkGameOver(&position) == 1 
+			|| probeTransposition(positionKey(&position, player), 0, &remainingdepth, &score, &bound, &bestfrom, &bestto) == 0 || bestfrom == NOSQUARE)
+		{
+			break;
+		}
+		move = packMove(bestfrom, bestto, 0);
+	}
+	return length;
+}
+
+void printSearchInfo(Position* pos, SearchContext* ctx, int whichplayer, const SearchResult* result)
+{//one info line for the depth that just finished.  The principal variation is walked with pvcontext, so the search's lists are left alone.
+	long long milliseconds = elapsedMilliseconds(ctx);
+	char line[1024];
+	int length = snprintf(line, sizeof(line), "info depth %d ", result->depth);
+	length += writeScore(result->score, line + length, sizeof(line) - length);
+	length += snprintf(line + length, sizeof(line) - length, " nodes %lld time %lld nps %lld", ctx->nodecount, milliseconds, 
+		ctx->nodecount*1000/max(milliseconds, 1LL));
+	writePrincipalVariation(pos, &pvcontext, whichplayer, result, line + length, sizeof(line) - length);
+	lock_guard<mutex> guard(protocollock);
+	cout << line << "\n" << flush;
+}
+
+void protocolSearch()
+{//search the protocol's position like makeAMove does, with an info line a depth, then print the best move.  runProtocol set up the
+	//context's limits and start time before starting the thread.
+	Position position = protocolposition;//the main thread doesn't touch it until this thread is joined, but it's cheap to copy
+	Position* pos = &position;
+	SearchContext* ctx = &protocolcontext;
+	int whichplayer = protocolplayer;
+	ctx->movenum[0] = 0;
+	if (whichplayer == 1)
+	{
+		findComputerMoves(pos, ctx, 0);
+	}
+	else
+	{
+		findHumanMoves(pos, ctx, 0);
+	}
+	char text[5] = "none";//the game is over
+	if (ctx->movenum[0] > 0 && checkGameOver(pos) == 0)
+	{
+		ttgeneration++;
+		ageHistory(ctx);
+		memset(ctx->killermoves, 0, sizeof(ctx->killermoves));
+		SearchResult result;
+		result.key = positionKey(pos, whichplayer);
+		result.move = ctx->listoflegalmoves[0];
+		result.score = BELOWWORST;
+		result.depth = 0;
+		result.complete = 0;
+		ctx->nodecount = 0;
+		ctx->searchaborted = 0;
+		memset(&ctx->stats, 0, sizeof(ctx->stats));
+		int firstdepth = 1;
+		if (probeBook(ctx, result.key, &result) == 1)
+		{//searched ahead of time
+			firstdepth = ctx->maxsearchdepth + 1;
+			printSearchInfo(pos, ctx, whichplayer, &result);
+		}
+		searchWithHelpers(pos, ctx, whichplayer, &result, firstdepth);
+		moveText(result.move, text);
+	}
+	while (protocolinfinite == 1 && protocolstop == 0)
+	{//go infinite:  The best move waits for stop.
+		this_thread::sleep_for(chrono::milliseconds(1));
+	}
+	lock_guard<mutex> guard(protocollock);
+	cout << "bestmove " << text << "\n" << flush;
+}
+
+void stopProtocolSearch()
+{//tell the search thread to stop, and wait for it to print its best move.  Nothing to do if it already finished.
+	if (protocolthread != NULL)
+	{
+		protocolstop = 1;
+		protocolthread->join();
+		delete protocolthread;
+		protocolthread = NULL;
+	}
+}
+
+void waitProtocolSearch()
+{//a command that needs the search thread to be done came in while it was searching:  Let it finish on its own, unless it's a go infinite,
+	//which wouldn't.
+	if (protocolinfinite == 1)
+	{
+		protocolstop = 1;
+	}
+	if (protocolthread != NULL)
+	{
+		protocolthread->join();
+		delete protocolthread;
+		protocolthread = NULL;
+	}
+}
+
+void setProtocolPosition()
+{//position startpos [first human|computer] [moves B3C4 F5E4 ...], or position notation <readNotation's four fields> [moves ...].
+	//From the start position the human goes first unless it says otherwise.  The moves stop at the first illegal one.
+	setup(&protocolposition);
+	protocolposition.horizontalhuman = 0;
+	protocolposition.horizontalcomputer = 0;
+	protocolplayer = 0;
+	for (char* word = strtok(NULL, " \t\r\n"); word != NULL; word = strtok(NULL, " \t\r\n"))
+	{
+		if (strcmp(word, "startpos") == 0 || strcmp(word, "moves") == 0)
+		{
+			continue;
+		}
+		if (strcmp(word, "first") == 0)
+		{
+			word = strtok(NULL, " \t\r\n");
+			protocolplayer = word != NULL && strcmp(word, "computer") == 0;
+		}
+		else if (strcmp(word, "notation") == 0)
+		{//put the fields back together for readNotation.
+			char notation[NOTATIONSIZE*2] = "";
+			for (int fieldnum = 0; fieldnum < 4 && (word = strtok(NULL, " \t\r\n")) != NULL; fieldnum++)
+			{
+				snprintf(notation + strlen(notation), sizeof(notation) - strlen(notation), fieldnum > 0 ? " %s" : "%s", word);
+			}
+			if (readNotation(&protocolposition, notation, &protocolplayer) == 0)
+			{
+				lock_guard<mutex> guard(protocollock);
+				cout << "info string not a position " << notation << "\n" << flush;
+				return;
+			}
+		}
+		else if (playMoveString(&protocolposition, &protocolcontext, protocolplayer, word) == 1)
+		{
+			protocolplayer = 1 - protocolplayer;
+		}
+		else
+		{
+			lock_guard<mutex> guard(protocollock);
+			cout << "info string illegal move " << word << "\n" << flush;
+			return;
+		}
+	}
+}
+
+void startProtocolSearch()
+{//go [depth <plies>] [nodes <nodes>] [movetime <ms>] [htime <ms>] [ctime <ms>] [hinc <ms>] [cinc <ms>] [infinite]
+	//htime and ctime are what's left on the human's and the computer's clocks, hinc and cinc what they get back each move.  With a clock, the
+	//side to move spends a twentieth of it plus most of its increment.  With only a depth or nodes, or infinite, the clock isn't looked at.
+	//With nothing, it's -time and -depth, like a real game.
+	int searchdepth = maxsearchdepth;
+	long long nodelimit = 0;
+	int searchtime = -1;
+	int clock[2] = {-1, -1};
+	int increment[2] = {0, 0};
+	int untimed = 0;
+	protocolinfinite = 0;
+	for (char* word = strtok(NULL, " \t\r\n"); word != NULL; word = strtok(NULL, " \t\r\n"))
+	{
+		if (strcmp(word, "infinite") == 0)
+		{
+			protocolinfinite = 1;
+			untimed = 1;
+			continue;
+		}
+		char* value = strtok(NULL, " \t\r\n");
+		if (value == NULL)
+		{
+			break;
+		}
+		if (strcmp(word, "depth") == 0)
+		{
+			searchdepth = min(max(atoi(value), 1), MAXDEPTH);
+			untimed = 1;
+		}
+		else if (strcmp(word, "nodes") == 0)
+		{
+			nodelimit = max(atoll(value), 1LL);
+			untimed = 1;
+		}
+		else if (strcmp(word, "movetime") == 0)
+		{
+			searchtime = max(atoi(value), 1);
+		}
+		else if (strcmp(word, "htime") == 0 || strcmp(word, "ctime") == 0)
+		{
+			clock[word[0] == 'c'] = max(atoi(value), 0);
+		}
+		else if (strcmp(word, "hinc") == 0 || strcmp(word, "cinc") == 0)
+		{
+			increment[word[0] == 'c'] = max(atoi(value), 0);
+		}
+	}
+	if (searchtime < 0 && clock[protocolplayer] >= 0)
+	{
+		searchtime = min(clock[protocolplayer]/20 + increment[protocolplayer]*3/4, max(clock[protocolplayer] - MOVEOVERHEAD, 1));
+	}
+	else if (searchtime < 0)
+	{
+		searchtime = untimed == 1 ? 1 << 30 : movetime;
+	}
 	
-	//Now make the real move.  Put the best move on the stack, to use it
-	movestack[0] = bestpiecetomovex;
-	movestack[1] = bestpiecetomovey;
-	movestack[2] = bestpiecenewx;
-	movestack[3] = bestpiecenewy;
-	movestack[4] = boardarray[yoffoldy + movestack[movestackoff]];
-    movestack[5] = boardarray[yoffnewy + movestack[movestackoff+2]];
-	movePiece(curdepth, bestpiecenum);//now really move the piece.
-	if (movestack[movestackoff + 4] == 'T' && checkListOfHorizontalMoves(bestmovenum,curdepth) == 1)
-	{//if this was a horizontal move, now ACTUALLY set the value.  No need to mod by LISTSIZE*curdepth, since the start is 0
-		horizontalcomputer = 2;
+	SearchContext* ctx = &protocolcontext;
+	ctx->searchstart = chrono::steady_clock::now();//the clock started when go came in
+	ctx->movetime = searchtime;
+	ctx->maxsearchdepth = searchdepth;
+	ctx->nodelimit = nodelimit;
+	ctx->stopflag = &protocolstop;
+	ctx->printinfo = 1;
+	protocolstop = 0;
+	protocolthread = new thread(protocolSearch);
+}
+
+void runProtocol()
+{//read commands until quit or the end of the input.  Searches run on their own thread, so stop and isready are answered while searching.
+	//Anything else waits for the search to finish first.
+	//kzp                          id name, id author, then kzpok
+	//isready                      readyok
+	//newgame                      forget the last game's history
+	//position ...                 see setProtocolPosition
+	//notation                     notation <the position, in readNotation's notation>
+	//go ...                       see startProtocolSearch.  info lines while it searches, then bestmove B3C4, or bestmove none if the game is over.
+	//stop                         stop searching, and print the best move so far
+	//quit
+	char line[PROTOCOLLINESIZE];
+	setup(&protocolposition);
+	protocolposition.horizontalhuman = 0;
+	protocolposition.horizontalcomputer = 0;
+	protocolplayer = 0;
+	while (fgets(line, sizeof(line), stdin) != NULL)
+	{
+		char* command = strtok(line, " \t\r\n");
+		if (command == NULL)
+		{
+			continue;
+		}
+		if (strcmp(command, "kzp") == 0)
+		{
+			lock_guard<mutex> guard(protocollock);
+			cout << "id name KaizoTrap\nid author Austin Purcell\nkzpok\n" << flush;
+		}
+		else if (strcmp(command, "isready") == 0)
+		{
+			lock_guard<mutex> guard(protocollock);
+			cout << "readyok\n" << flush;
+		}
+		else if (strcmp(command, "newgame") == 0)
+		{
+			waitProtocolSearch();
+			ttgeneration++;
+			memset(protocolcontext.historytable, 0, sizeof(protocolcontext.historytable));
+		}
+		else if (strcmp(command, "position") == 0)
+		{
+			waitProtocolSearch();
+			setProtocolPosition();
+		}
+		else if (strcmp(command, "notation") == 0)
+		{
+			char notation[NOTATIONSIZE];
+			writeNotation(&protocolposition, protocolplayer, notation);
+			lock_guard<mutex> guard(protocollock);
+			cout << "notation " << notation << "\n" << flush;
+		}
+		else if (strcmp(command, "go") == 0)
+		{
+			waitProtocolSearch();
+			startProtocolSearch();
+		}
+		else if (strcmp(command, "stop") == 0)
+		{
+			stopProtocolSearch();
+		}
+		else if (strcmp(command, "quit") == 0)
+		{
+			stopProtocolSearch();
+			return;
+		}
+		else
+		{
+			lock_guard<mutex> guard(protocollock);
+			cout << "info string unknown command " << command << "\n" << flush;
+		}
+	}
+	waitProtocolSearch();//the input ended:  Still print the best move.
+}
+
+long long analysePosition(Position* pos, SearchContext* ctx, const char* line, char* output)
+{//search the line's position like self play does, and write the line with the best move, score, depth, nodes and principal variation
+	//after it.  Lines that aren't positions get an error instead, so the output still lines up with the input.
+	int whichplayer;
+	if (readNotation(pos, line, &whichplayer) == 0)
+	{
+		snprintf(output, ANALYSISOUTPUTSIZE, "%s error not a position", line);
+		return 0;
+	}
+	ctx->movenum[0] = 0;
+	if (whichplayer == 1)
+	{
+		findComputerMoves(pos, ctx, 0);
+	}
+	else
+	{
+		findHumanMoves(pos, ctx, 0);
+	}
+	if (ctx->movenum[0] == 0 || checkGameOver(pos) == 1)
+	{
+		snprintf(output, ANALYSISOUTPUTSIZE, "%s bestmove none", line);
+		return 0;
 	}
+	SearchResult result;
+	result.key = positionKey(pos, whichplayer);
+	result.move = ctx->listoflegalmoves[0];
+	result.score = BELOWWORST;
+	result.depth = 0;
+	result.complete = 0;
+	ttgeneration++;
+	ageHistory(ctx);
+	memset(ctx->killermoves, 0, sizeof(ctx->killermoves));
+	ctx->searchstart = chrono::steady_clock::now();
+	ctx->nodecount = 0;
+	ctx->searchaborted = 0;
+	memset(&ctx->stats, 0, sizeof(ctx->stats));
+	searchMoves(pos, ctx, whichplayer, &result, 1);
 	
-    cout << "I made my move " << xold << yold << xnew << ynew << " ( " << xoldinv << yoldinv << xnewinv << ynewinv << " )\n";
-	cout << "evaluation result is " << best << "\n";
-    //showPieces();//debug
-	//showListStack(MAXDEPTH);//debug
-    //showAllMoves();//debug
-	return best;
+	char movetext[5];
+	moveText(result.move, movetext);
+	int length = snprintf(output, ANALYSISOUTPUTSIZE, "%s bestmove %s ", line, movetext);
+	length += writeScore(result.score, output + length, max(ANALYSISOUTPUTSIZE - length, 0));
+	length += snprintf(output + length, max(ANALYSISOUTPUTSIZE - length, 0), " depth %d nodes %lld", result.depth, ctx->nodecount);
+	writePrincipalVariation(pos, ctx, whichplayer, &result, output + length, max(ANALYSISOUTPUTSIZE - length, 0));//the search is done with the lists
+	return ctx->nodecount;
+}
+
+void analysisWorker(long long* nodes)
+{//take the next position read, search it, and mark its slot done, until there are none left.  Each worker has its own position and
+	//context, like the self play workers.  They share the transposition table.
+	Position position = {};
+	SearchContext context = {};
+	SearchContext* ctx = &context;
+	ctx->maxsearchdepth = maxsearchdepth;
+	ctx->movetime = (analysisnodes > 0 || maxsearchdepth < MAXDEPTH) ? 1 << 30 : movetime;//a depth or node limit decides how long it takes
+	ctx->nodelimit = analysisnodes;
+	for (;;)
+	{
+		long long sequence;
+		{
+			unique_lock<mutex> guard(analysislock);
+			analysissignal.wait(guard, [] { return analysistaken < analysisread || analysisfinished == 1; });
+			if (analysistaken == analysisread)
+			{
+				return;
+			}
+			sequence = analysistaken++;
+		}
+		AnalysisSlot* slot = &analysisslots[sequence % ANALYSISSLOTS];//nobody else touches it until it's done
+		*nodes += analysePosition(&position, ctx, slot->line, slot->output);
+		{
+			lock_guard<mutex> guard(analysislock);
+			slot->done = 1;
+		}
+		analysissignal.notify_all();
+	}
+}
+
+void analysisWriter(FILE* file)
+{//write each slot's result as soon as it and every one before it are done, then free the slot for the reader.
+	for (;;)
+	{
+		AnalysisSlot* slot;
+		{
+			unique_lock<mutex> guard(analysislock);
+			analysissignal.wait(guard, [] { return (analysiswritten < analysisread && analysisslots[analysiswritten % ANALYSISSLOTS].done == 1)
+				|| (analysisfinished == 1 && analysiswritten == analysisread); });
+			if (analysiswritten == analysisread)
+			{
+				return;
+			}
+			slot = &analysisslots[analysiswritten % ANALYSISSLOTS];
+		}
+		fputs(slot->output, file);
+		fputc('\n', file);
+		{
+			lock_guard<mutex> guard(analysislock);
+			slot->done = 0;
+			analysiswritten++;
+		}
+		analysissignal.notify_all();
+	}
 }
 
+void runAnalysis()
+{//read the positions on this thread into free slots, while the workers search them and the writer writes them out.  Blank lines and
+	//lines starting with # are skipped.  A line too long to be a position is cut short, and gets an error.  The summary goes to stderr,
+	//so it doesn't end up in the results.
+	FILE* input = strcmp(analysisinput, "-") == 0 ? stdin : fopen(analysisinput, "r");
+	FILE* output = strcmp(analysisoutput, "-") == 0 ? stdout : fopen(analysisoutput, "w");
+	if (input == NULL || output == NULL)
+	{
+		cerr << "couldn't open " << (input == NULL ? analysisinput : analysisoutput) << "\n";
+		exit(1);
+	}
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	analysisread = 0;
+	analysistaken = 0;
+	analysiswritten = 0;
+	analysisfinished = 0;
+	thread workers[MAXTHREADS];
+	long long workernodes[MAXTHREADS] = {};
+	for (int workernum = 0; workernum < selfplayworkers; workernum++)
+	{
+		workers[workernum] = thread(analysisWorker, &workernodes[workernum]);
+	}
+	thread writer(analysisWriter, output);
+	
+	char line[ANALYSISLINESIZE];
+	while (fgets(line, sizeof(line), input) != NULL)
+	{
+		int length = strlen(line);
+		if (length == ANALYSISLINESIZE - 1 && line[length - 1] != '\n')
+		{//skip the rest of it
+			int character = fgetc(input);
+			while (character != '\n' && character != EOF)
+			{
+				character = fgetc(input);
+			}
+		}
+		while (length > 0 && (line[length - 1] == '\n' || line[length - 1] == '\r'))
+		{
+			line[--length] = '\0';
+		}
+		if (length == 0 || line[0] == '#')
+		{
+			continue;
+		}
+		{
+			unique_lock<mutex> guard(analysislock);
+			analysissignal.wait(guard, [] { return analysisread - analysiswritten < ANALYSISSLOTS; });
+			memcpy(analysisslots[analysisread % ANALYSISSLOTS].line, line, length + 1);
+			analysisread++;
+		}
+		analysissignal.notify_all();
+	}
+	{
+		lock_guard<mutex> guard(analysislock);
+		analysisfinished = 1;
+	}
+	analysissignal.notify_all();
+	long long nodes = 0;
+	for (int workernum = 0; workernum < selfplayworkers; workernum++)
+	{
+		workers[workernum].join();
+		nodes += workernodes[workernum];
+	}
+	writer.join();
+	if (input != stdin)
+	{
+		fclose(input);
+	}
+	if (output != stdout && fclose(output) != 0)
+	{
+		cerr << "couldn't write " << analysisoutput << "\n";
+		exit(1);
+	}
+	fflush(stdout);
+	long long microseconds = chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - start).count();
+	cerr << analysisread << " positions, " << nodes << " nodes in " << microseconds/1000 << " ms on " << selfplayworkers << " workers, " 
+		<< (long long)(analysisread*1000000.0/max(microseconds, 1LL)) << " positions per second\n";
+}
 
-int getHumanMove()
+int getHumanMove(Position* pos, SearchContext* ctx)
 {//get the human move:
     /*Do this by first getting the piece based on the position (x and y values)
         Then, move that piece.  The validationchecking makes sure that the move works.
     */
-	movenum[0] = 0;//start with no legal moves
-    findHumanMoves(0);//find the list of moves a human can make.
+	ctx->movenum[0] = 0;//start with no legal moves
+    findHumanMoves(pos, ctx, 0);//find the list of moves a human can make.
     //cout << "finished finding human moves\n";//debug
 	   
-    showListOfMoves(0);//show the list of moves.
-	if (checkNoMoves(0, 0) == 1)
+    showListOfMoves(pos, ctx, 0);//show the list of moves.
+	if (checkNoMoves(ctx, 0, 0) == 1)
 	{//makes sure there is a list of moves.  If not, end the game.
 		exit(0);//AI won.
 	}
-	printBoard();//Show the board state, after the moves have been shown.
+	printBoard(pos);//Show the board state, after the moves have been shown.
     //ask user for x and y coordinate of piece.
     cout << "Enter the play to be made (Current xy, then New xy):  ";
-    scanf("%s", userinput);
+    scanf("%15s", userinput);
     
-    movestack[0] = userinput[0] - 'A';//Since this is ASCII, i'll just minus by 'A'(65), to get the ascii to 0, then add 1.  The difference
+    int oldx = userinput[0] - 'A';//Since this is ASCII, i'll just minus by 'A'(65), to get the ascii to 0, then add 1.  The difference
     //is the actual spot, ex. 'C' - 'A' = 2, all nice and dandy :) .
-    movestack[1] = YWIDTH - (userinput[1] - '0');//Since the input is one off our array, just minus by one, the displacement.
+    int oldy = YWIDTH - (userinput[1] - '0');//Since the input is one off our array, just minus by one, the displacement.
     //However, since this is in ASCII, we minus by ASCII 1.
     //We also have to inverse the values:  1 = 6, 2 = 5, 7 = 0 etc.
     //(a + a') mod b = 0
     //b - a = a'
-    movestack[2] = userinput[2] - 'A';//Same as movestack[0];
-    movestack[3] = YWIDTH - (userinput[3] - '0');//Same as movestack[0 + 1];
-
-    movestack[4] = boardarray[YWIDTH*movestack[1] + movestack[0]];//get the piece
+    int newx = userinput[2] - 'A';//Same as oldx;
+    int newy = YWIDTH - (userinput[3] - '0');//Same as oldy;
+	int from = -1;//off the board matches nothing
+	int to = -1;
+	if (oldx >= 0 && oldx < XWIDTH && oldy >= 0 && oldy < YWIDTH && newx >= 0 && newx < XWIDTH && newy >= 0 && newy < YWIDTH)
+	{
+		from = oldy*YWIDTH + oldx;
+		to = newy*YWIDTH + newx;
+	}
 
     int imessup = 0;//indicates the person messed up
-	imessup = checkListOfMoves();//check the move based on the list of legal moves
+	imessup = checkListOfMoves(ctx, from, to);//check the move based on the list of legal moves.  It puts the move on the stack.
     //I could just put this here, to waste time, instead of check based on list of moves.  Hehehe...
     return imessup;
     
 }
 
 
-void movePiece(int curdepth, int piecenum)
-{//move the piece to the new location, and have the old location replaced by a blank space
+void movePiece(Position* pos, SearchContext* ctx, int curdepth)
+{//move the piece to the new location, and have the old location replaced by a blank space.  The move is the one on the stack at curdepth.
 	//if trumove is 1, then we also look for the piece that moved:  Otherwise, ignore it
 	//shouldn't have to do above, so commented out.
+	Move move = ctx->movestack[curdepth];
+	UndoRecord* undo = &ctx->undostack[curdepth];
+	int piecenum = movedPiece(move);
+	int from = moveFrom(move);
+	int to = moveTo(move);
+	undo->evaluation = pos->evaluation;
+	undo->zobristkey = pos->zobristkey;
+	int* horizontal = &pos->horizontalhuman;//the moving side's horizontal tie value:  A turn went by for it.
+	if (piecenum >= NUMOFPIECES*2)
+	{
+		horizontal = &pos->horizontalcomputer;
+	}
+	undo->horizontal = *horizontal;
+	if (move & MOVEHORIZONTAL)
+	{//it can't move a tie fighter sideways on its next turn.
+		*horizontal = 2;
+	}
+	else if (*horizontal > 0)
+	{
+		*horizontal = *horizontal - 1;
+	}
 	
 	//update the piece position on list of piece positions.
 	//do piecenum*2 because if you don't you'll interfere with the next piece's location.  
 	// ex.  piecenum = 0  1    2  3 
 	//				  [x1 y1] [x2 y2]
-	piecepositions[piecenum*2] = movestack[movestackoff + 3];//new y location.
-	piecepositions[piecenum*2 + 1] = movestack[movestackoff + 2];//new x location.
+	pos->piecepositions[piecenum*2] = to / XWIDTH;//new y location.
+	pos->piecepositions[piecenum*2 + 1] = to % XWIDTH;//new x location.
 	//cout << "piecenum move " << piecenum << " moved to " << char(piecepositions[piecenum*2 + 1] + 'A') << char(YWIDTH - piecepositions[piecenum*2] + '0') << "\n";
 	
 	
-	checkPieceRemoved(curdepth, piecenum);
+	checkPieceRemoved(pos, ctx, curdepth);
 	
     //do this before actually swapping, or error will occur (checkpiece will check this piece moving).
+	pos->pieceboards[piecenum/NUMOFPIECES] ^= (1ULL << from) | (1ULL << to);
+	pos->zobristkey ^= zobrist.pieces[piecenum/NUMOFPIECES][from] ^ zobrist.pieces[piecenum/NUMOFPIECES][to];
+	pos->squarepieces[from] = NOPIECE;
+	pos->squarepieces[to] = piecenum;
     
-    boardarray[yoffnewy + movestack[movestackoff+2]] = movestack[movestackoff + 4];//replace the new spot with the piece
-    boardarray[yoffoldy + movestack[movestackoff]] = EMPTYCHAR;//clear the old place with a blank spot.
-    //don't replace it with a potential movestack[movestackoff + 5];  That's the piece being captured.  don't flip em.
+    pos->boardarray[to] = PIECECHARS[piecenum/NUMOFPIECES];//replace the new spot with the piece
+    pos->boardarray[from] = EMPTYCHAR;//clear the old place with a blank spot.
+    //the piece being captured is remembered in the undo record, by checkPieceRemoved.
 }
 
-//if whichplayer = 0, it is human.  Computer otherwise.
-void resetPiecePosition( int whichplayer, int curdepth, int piecenum)
+void resetPiecePosition(Position* pos, SearchContext* ctx, int curdepth)
 {//undo the piece move, rather than a whole board move
     //cout << "resetting piece position\n";//debug
+	Move move = ctx->movestack[curdepth];
+	const UndoRecord* undo = &ctx->undostack[curdepth];
+	int piecenum = movedPiece(move);
+	int from = moveFrom(move);
+	int to = moveTo(move);
+	int captured = undo->captured;
 	
 	//update the piece position on list of piece positions:  Go backwards
-	piecepositions[piecenum*2] = movestack[movestackoff + 1];//old y location
-	piecepositions[piecenum*2+1] = movestack[movestackoff];
+	pos->piecepositions[piecenum*2] = from / XWIDTH;//old y location
+	pos->piecepositions[piecenum*2+1] = from % XWIDTH;
 	//cout << "piecenum undone move " << piecenum << " moved to " << char(piecepositions[piecenum*2 + 1] + 'A') << char(YWIDTH - piecepositions[piecenum*2] + '0') << "\n";
 	
-	char piecetolife = EMPTYCHAR;//the piece that will replace the undone location (newx and newy)
+	pos->pieceboards[piecenum/NUMOFPIECES] ^= (1ULL << from) | (1ULL << to);
+	pos->zobristkey = undo->zobristkey;
+	pos->evaluation = undo->evaluation;
+	if (piecenum >= NUMOFPIECES*2)
+	{
+		pos->horizontalcomputer = undo->horizontal;
+	}
+	else
+	{
+		pos->horizontalhuman = undo->horizontal;
+	}
+	pos->squarepieces[from] = piecenum;
+	pos->squarepieces[to] = captured;
 		
-	if (movestack[movestackoff + 5] < 16)
+	char piecetolife = EMPTYCHAR;//the piece that will replace the undone location (newx and newy)
+	if (captured != NOPIECE)
 	{
-		capturedpieces[movestack[movestackoff + 5]] = 0;//reset piece captured: It is no longer captured.
-		if (movestack[movestackoff + 5] < 4)
-		{//if this is a human x wing
-			//cout << "Uncapturing human x wing\n";
-			piecetolife = 'x';
-		}
-		else if (movestack[movestackoff + 5] < 8)
-		{
-			//cout << "Uncapturing human tie\n";
-			piecetolife = 't';
-		}
-		else if (movestack[movestackoff + 5] < 12)
-		{
-			//cout << "Uncapturing comp x wing\n";		
-			piecetolife = 'X';
-		}
-		else
-		{
-			//cout << "Uncapturing comp tie fighter\n";		
-			piecetolife = 'T';
-		}
+		pos->capturedpieces[captured] = 0;//reset piece captured: It is no longer captured.
+		pos->pieceboards[captured/NUMOFPIECES] |= 1ULL << to;//put it back on its bitboard
+		piecetolife = PIECECHARS[captured/NUMOFPIECES];
 	}
-
-
 	
-	//cout << "printing 'o' at " << char(movestack[movestackoff+2]+ 'A') << char(YWIDTH - movestack[movestackoff+3] + '0') << "\n";//debugt
-	boardarray[yoffnewy + movestack[movestackoff+2]] = piecetolife;//replace the new spot with the old spot, which was the 'captured' piece.
+	//cout << "printing 'o' at " << char(to % XWIDTH + 'A') << char(YWIDTH - to / XWIDTH + '0') << "\n";//debug
+	pos->boardarray[to] = piecetolife;//replace the new spot with the old spot, which was the 'captured' piece.
 	
 	
-	//cout << "Current piece to reset is " << piecetomove << "\n";          //movestack[5*curdepth + 4]
-    boardarray[yoffoldy + movestack[movestackoff]] = movestack[movestackoff + 4];//replace the old spot with the piece originally there..
+    pos->boardarray[from] = PIECECHARS[piecenum/NUMOFPIECES];//replace the old spot with the piece originally there..
 
-	boardarray[10] = '*';//just reset these, just because I know that these will always be reverted.
-	boardarray[38] = '@';
+	pos->boardarray[10] = '*';//just reset these, just because I know that these will always be reverted.
+	pos->boardarray[38] = '@';
 }
 
-int checkPieceRemoved(int curdepth, int piecenum)
+int checkPieceRemoved(Position* pos, SearchContext* ctx, int curdepth)
 {//checks to see if a piece was removed, or rather, if the new location interfered with what the old location was.
-	//cout << "CHecking piece captured...\n";//debug
-    for (int piecetocheck = 0; piecetocheck < NUMOFPIECES; piecetocheck ++)
-	{//check each piece to see if their old move matches with the move actually made.  Also, make sure the piece isn't captured, it's redundant
-		//also...make sure the piece doesn't capture itself (piecetocheck != piecenum)
-		if (capturedpieces[piecetocheck] == 0 && piecetocheck != piecenum 
-            && movestack[movestackoff+3] == piecepositions[piecetocheck*2] && movestack[movestackoff + 2] == piecepositions[piecetocheck*2+1] 
-			)
-		{//if the human x wing piece was taken (new position is equal to where they are now).
-
-			capturedpieces[piecetocheck] = captureindicator;
-            captureindicator++;
-            movestack[movestackoff + 5] = piecetocheck;//put the piecenum that was captured, so we can easily undo the capture if it occurred.
-            
-            //cout << "captureing: captureindicator is now " << captureindicator << " by " << piecenum << "\n";          
-			//cout << "Human x wing " << piecetocheck << " captured at " << char(movestack[movestackoff+2] + 'A') << char(YWIDTH - movestack[movestackoff+3] + '0') << " from " 
-			//	<< char(movestack[movestackoff] + 'A') << char(YWIDTH - movestack[movestackoff+1] + '0') << "\n";//debug
-			return 0;
-		}
-		else if (capturedpieces[piecetocheck+4] == 0 && piecetocheck + 4 != piecenum 
-            && movestack[movestackoff+3] == piecepositions[piecetocheck*2+8] && movestack[movestackoff + 2] == piecepositions[piecetocheck*2+9] 
-			)
-		{//human TIE fighter
-
-			capturedpieces[piecetocheck + 4] = captureindicator;
-            captureindicator++;
-            movestack[movestackoff + 5] = piecetocheck+4;
-
-            //cout << "captureing:  captureindicator is now " << captureindicator << " by " << piecenum << "\n";      
-            //cout << "Human Tie fighter " << counter << " captured at " << char(movestack[movestackoff+2] + 'A') << char(YWIDTH - movestack[movestackoff+3] + '0') <<"\n";//debug
-			return 0;
-		}
-		else if (capturedpieces[piecetocheck+8] == 0 && piecetocheck + 8 != piecenum 
-            && movestack[movestackoff+3] == piecepositions[piecetocheck*2+16] && movestack[movestackoff + 2] == piecepositions[piecetocheck*2+17]
-			)
-		{//computer x wing
-
-			capturedpieces[piecetocheck + 8] = captureindicator;
-            captureindicator++;
-            movestack[movestackoff + 5] = piecetocheck + 8;
-            
-            //cout << "captureing:   captureindicator is now " << captureindicator << " by " << char(piecetomove) << "\n";                    
-			//cout << "Computer x wing " << counter << " captured at " << char(movestack[movestackoff+2] + 'A') << char(YWIDTH - movestack[movestackoff+3] + '0') <<"\n";//debug
-			return 0;
-		}
-		else if (capturedpieces[piecetocheck + 12] == 0 && piecetocheck + 12 != piecenum 
-            && movestack[movestackoff+3] == piecepositions[piecetocheck*2+24] && movestack[movestackoff + 2] == piecepositions[piecetocheck*2+25]
-			)
-		{//computer TIE fighter
-
-			capturedpieces[piecetocheck + 12] = captureindicator;
-            captureindicator++;
-            movestack[movestackoff + 5] = piecetocheck + 12;
-            
-            //cout << "captureing:    captureindicator is now " << captureindicator << " by " << char(piecetomove) << "\n";             
-			//cout << "Computer Tie fighter " << counter << " captured at " << char(movestack[movestackoff+2] + 'A') << char(YWIDTH - movestack[movestackoff+3] + '0') <<"\n";//debug
-			return 0;
-		}
+	Move move = ctx->movestack[curdepth];
+	int to = moveTo(move);
+	int captured = pos->squarepieces[to];//the generator only puts enemies and empty squares on the list, so whatever is there gets captured.
+	ctx->undostack[curdepth].captured = captured;
+	if (captured == NOPIECE)
+	{
+		return 1;//here, nothing was captured
 	}
-	movestack[movestackoff + 5] = 32;//dummy value, to revert to a blank space.
-	return 1;//here, nothing was captured
-}
-
-void doubleCaptureIndicators()
-{//double the capture values, so they do not get uncaptured.
-    for (int counter = 0; counter < NUMOFPIECES*4; counter++)
-    {
-        if (capturedpieces[counter] < NUMOFPIECES*4)
-        {
-            capturedpieces[counter] = capturedpieces[counter] * NUMOFPIECES*4;//basically, go to a number such that this can never be unremoved
-        }
-    }
-
+	pos->capturedpieces[captured] = 1;
+	pos->pieceboards[captured/NUMOFPIECES] &= ~(1ULL << to);
+	pos->zobristkey ^= zobrist.pieces[captured/NUMOFPIECES][to];
+	pos->evaluation += CAPTUREVALUES[captured/NUMOFPIECES];
+	//cout << "captureing: piece " << captured << " by " << movedPiece(move) << "\n";
+	return 0;
 }
-